@@ -0,0 +1,107 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Runs a command once and measures it for the benchmarks (see run.sh): the wall time,
+ * the events it printed out (one per line), the events per second, the peak resident
+ * memory and the bytes it wrote (printed out and, if given, in the results file).
+ * These are printed out in one line:
+ * 		[Seconds] [Events] [Events per second] [Peak RSS in KB] [Output bytes]
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* memchr */
+#include <time.h>       /* clock_gettime */
+#include <unistd.h>     /* fork, pipe, getopt */
+#include <sys/stat.h>   /* stat */
+#include <sys/wait.h>   /* wait4 */
+#include <sys/resource.h> /* rusage */
+#define READ_SIZE 65536 //number of bytes of the output read at once
+
+
+
+/*
+ * Function: main
+ * --------------
+ * runs the command given after the options, counting the lines and bytes it prints
+ * out, and waits for it to finish. -o gives the results file it writes, whose size is
+ * added to the bytes.
+ *
+ * argc: argument counter, which is the number of arguments the user input
+ * argv: array containing all the arguments the user input
+ *
+ * returns: none
+ */
+int main(int argc, char* argv[])
+{
+	int option;
+	char *results=NULL; //results file of the command
+	char buffer[READ_SIZE];
+	int fds[2];
+	pid_t pid;
+	int status;
+	struct rusage usage;
+	struct timespec start;
+	struct timespec end;
+	struct stat file;
+	long size;
+	long events=0;
+	long bytes=0;
+	char *line;
+	double seconds;
+
+	while ((option=getopt(argc, argv, "+o:"))!=-1){
+		if (option=='o'){
+			results=optarg;
+		}
+		else{
+			optind=argc;
+		}
+	}
+	if (optind>=argc){
+		printf("Usage: %s [-o results file] command [arguments]\n", argv[0]);
+		exit(0);
+	}
+	if (results!=NULL){
+		remove(results);
+	}
+
+	if (pipe(fds)!=0){
+		printf("The output of the command could not be read");
+		exit(0);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	pid=fork();
+	if (pid==0){
+		dup2(fds[1], STDOUT_FILENO);
+		close(fds[0]);
+		close(fds[1]);
+		execvp(argv[optind], argv+optind);
+		_exit(127);
+	}
+	close(fds[1]);
+	/*the events are counted as they are printed out*/
+	while ((size=read(fds[0], buffer, READ_SIZE))>0){
+		bytes+=size;
+		line=buffer;
+		while ((line=memchr(line, '\n', buffer+size-line))!=NULL){
+			events+=1;
+			line+=1;
+		}
+	}
+	close(fds[0]);
+	wait4(pid, &status, 0, &usage);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	if (!WIFEXITED(status) || WEXITSTATUS(status)==127){
+		printf("The command could not be run\n");
+		exit(0);
+	}
+
+	if (results!=NULL && stat(results, &file)==0){
+		bytes+=file.st_size;
+	}
+	seconds=(end.tv_sec-start.tv_sec)+(end.tv_nsec-start.tv_nsec)/1e9;
+	printf("%10.3f %12ld %14.0f %12ld %14ld\n", seconds, events, seconds>0 ? events/seconds : 0, usage.ru_maxrss, bytes);
+	exit(0);
+}
@@ -0,0 +1,67 @@
+#!/bin/sh
+#
+# Checks the program against small processes files whose events are worked out by hand:
+# every case gives the options, the processes file and the times at which the processes
+# finish, and the finish lines the program prints out have to be the same. Unlike
+# replay.sh, which only compares two builds, this catches a behavior both builds share.
+#
+# usage: bench/check.sh
+# The work directory is /tmp/scheduler-check, or CHECK_DIR if it is set.
+
+set -e
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=${CHECK_DIR:-/tmp/scheduler-check}
+
+mkdir -p "$work"
+gcc -O2 -pthread -o "$work/scheduler" "$root"/*.c
+
+cd "$work"
+failures=0
+
+# check [options] : the processes file is on the standard input, and the expected
+# finish lines ("time name", one per line) are in expected.txt
+check(){
+	cat > processes.txt
+	./scheduler "$@" processes.txt | awk '/has finished execution/ { sub(":", "", $2); print $2, $3 }' > finished.txt
+	if ! cmp -s expected.txt finished.txt; then
+		echo "fails: $*"
+		diff expected.txt finished.txt || true
+		failures=$((failures+1))
+	fi
+}
+
+# round robin of two processes, without and with a switch cost: the 2 seconds of every
+# switch are not taken from the quantum of the process
+printf "9 A\n10 B\n" > expected.txt
+check -p mlfq -Q 2 <<EOF
+A 0 5 10
+B 0 5 10
+EOF
+printf "19 A\n22 B\n" > expected.txt
+check -p mlfq -Q 2 -s 2 <<EOF
+A 0 5 10
+B 0 5 10
+EOF
+check -p stride -q 2 -s 2 <<EOF
+A 0 5 10
+B 0 5 10
+EOF
+
+# a process which arrives while the switch to another one is paid for: the first one
+# keeps its whole quantum of 3 seconds, and both go down to the quantum of 6 seconds
+printf "13 A\n16 B\n" > expected.txt
+check -p mlfq -Q 3,6 -s 2 <<EOF
+A 0 4 10
+B 1 4 10
+EOF
+
+# MLFQ ignores -q: the first process goes down a level after the 8 seconds of the top
+# one, not on the next multiple of the quantum of 3 seconds
+printf "28 A\n40 B\n" > expected.txt
+check -p mlfq -Q 8,16 -q 3 <<EOF
+A 0 20 40
+B 0 20 40
+EOF
+
+echo "$failures failures"
+[ "$failures" -eq 0 ]
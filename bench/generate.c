@@ -0,0 +1,151 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Generator of synthetic processes files for the benchmarks (see run.sh). It prints
+ * out the given number of processes, one per line, in form of:
+ * 		[Process Name] [Arrival Time] [Service Time] [Deadline]
+ * The processes arrive as a Poisson process, their service times are heavy-tailed
+ * (Pareto) and their deadlines are either tight or loose. The same options and seed
+ * always give the same file, on any machine.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* string operations */
+#include <math.h>       /* log, pow, ceil */
+#include <unistd.h>     /* getopt */
+#define SAMPLES 100000 //number of service times drawn to find their mean
+
+/*functions*/
+double next_uniform(unsigned long long *state);
+int next_service(unsigned long long *state, double alpha, int max_service);
+
+
+
+/*
+ * Function: main
+ * --------------
+ * reads the options and prints out the processes:
+ *		-n count: number of processes (1000 by default)
+ *		-s seed: seed of the random numbers (1 by default)
+ *		-u load: share of the time the CPU is expected to be busy, which sets how
+ *				often the processes arrive (0.9 by default)
+ *		-a alpha: shape of the Pareto distribution of the service times, the smaller
+ *				the heavier the tail (1.5 by default)
+ *		-m max: longest service time (1000 by default)
+ *		-d tight|loose: deadlines of at most 1.5 times the service time, or of 2 to 10
+ *				times the service time (tight by default)
+ *
+ * argc: argument counter, which is the number of arguments the user input
+ * argv: array containing all the arguments the user input
+ *
+ * returns: none
+ */
+int main(int argc, char* argv[])
+{
+	int option;
+	long count=1000;
+	unsigned long long seed=1;
+	double load=0.9;
+	double alpha=1.5;
+	int max_service=1000;
+	int tight=1; //1 for tight deadlines, 0 for loose ones
+	unsigned long long state;
+	double mean_service=0;
+	double rate; //processes arriving per second
+	double arrival=0;
+	int service;
+	int deadline;
+	long look_up;
+
+	while ((option=getopt(argc, argv, "n:s:u:a:m:d:"))!=-1){
+		if (option=='n' && atol(optarg)>0){
+			count=atol(optarg);
+		}
+		else if (option=='s'){
+			seed=strtoull(optarg, NULL, 10);
+		}
+		else if (option=='u' && atof(optarg)>0){
+			load=atof(optarg);
+		}
+		else if (option=='a' && atof(optarg)>0){
+			alpha=atof(optarg);
+		}
+		else if (option=='m' && atoi(optarg)>0){
+			max_service=atoi(optarg);
+		}
+		else if (option=='d' && !strcmp(optarg, "tight")){
+			tight=1;
+		}
+		else if (option=='d' && !strcmp(optarg, "loose")){
+			tight=0;
+		}
+		else{
+			printf("Usage: %s [-n count] [-s seed] [-u load] [-a alpha] [-m max service] [-d tight|loose]\n", argv[0]);
+			exit(0);
+		}
+	}
+
+	/*the rate of arrivals is set from the mean service time, drawn from a seed of its own*/
+	state=seed^0x5DEECE66DULL;
+	for (look_up=0; look_up<SAMPLES; look_up++){
+		mean_service+=next_service(&state, alpha, max_service);
+	}
+	mean_service/=SAMPLES;
+	rate=load/mean_service;
+
+	state=seed;
+	for (look_up=0; look_up<count; look_up++){
+		/*the time between two arrivals is exponential*/
+		arrival+=-log(1-next_uniform(&state))/rate;
+		service=next_service(&state, alpha, max_service);
+		if (tight){
+			deadline=service+(int)ceil(service*0.5*next_uniform(&state));
+		}
+		else{
+			deadline=(int)ceil(service*(2+8*next_uniform(&state)));
+		}
+		printf("P%ld %ld %d %d\n", look_up+1, (long)arrival, service, deadline);
+	}
+	exit(0);
+}
+
+/*
+ * Function: next_uniform
+ * -------------------
+ * gives the next random number (splitmix64), which does not depend on the C library
+ *
+ * state: state of the random numbers
+ *
+ * returns: a number from 0 (included) to 1 (excluded)
+ */
+double next_uniform(unsigned long long *state){
+	unsigned long long number;
+	*state+=0x9E3779B97F4A7C15ULL;
+	number=*state;
+	number=(number^(number>>30))*0xBF58476D1CE4E5B9ULL;
+	number=(number^(number>>27))*0x94D049BB133111EBULL;
+	number=number^(number>>31);
+	return (number>>11)*(1.0/9007199254740992.0);
+}
+
+/*
+ * Function: next_service
+ * -------------------
+ * gives the next service time: Pareto with the smallest value of 1 second, rounded up
+ * and cut at the longest service time
+ *
+ * state: state of the random numbers
+ * alpha: shape of the distribution
+ * max_service: longest service time
+ *
+ * returns: the service time in seconds
+ */
+int next_service(unsigned long long *state, double alpha, int max_service){
+	double service=ceil(1/pow(1-next_uniform(state), 1/alpha));
+	if (service>max_service){
+		return max_service;
+	}
+	return (int)service;
+}
@@ -0,0 +1,496 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Differential replay of the scheduler (see replay.sh): runs a reference build and a
+ * candidate build of the program on the same processes file with the same options, each
+ * in a directory of its own, and compares everything they wrote (the printed out events,
+ * the results files and how they exited) line by line, or only the given file of them.
+ * Any difference is printed out:
+ * 		[File]:[Line]: reference: [Line of the reference]
+ * 		[File]:[Line]: candidate: [Line of the candidate]
+ *
+ * With -m, once the builds differ, the processes file is cut down to as few lines as
+ * still show a difference (removing halves of it, then quarters and so on, as long as
+ * the builds still differ without them), and written into the given file, so that the
+ * difference can be looked into on a handful of processes.
+ *
+ * The reference may take options of its own (-R), so that revisions which did not have
+ * all the options yet, or the original programs which took none, can be compared too.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* strcmp, strlen */
+#include <unistd.h>     /* fork, chdir, getopt */
+#include <dirent.h>     /* opendir */
+#include <sys/wait.h>   /* waitpid */
+#define TIME_LIMIT 60 //default number of seconds a run may take
+#define MAX_OPTIONS 64 //most options the reference may be given with -R
+
+/* Lines of the processes file*/
+typedef struct{
+	char **lines; //the lines, each with its new line character
+	int count; //number of lines
+} lines_t;
+
+/*functions*/
+int replay(char **binaries, char **directories, char *trace, char **options[], char *only, int time_limit, int report);
+int run(char *binary, char *directory, char *trace, char **options, int time_limit);
+int compare_directories(char **directories, char *only, int report);
+int compare_files(char **directories, char *name, int report);
+void clean_directory(char *directory);
+void read_lines(char *filename, lines_t *lines);
+void write_lines(char *filename, lines_t *lines, int skip_start, int skip_count);
+int minimize(char **binaries, char **directories, lines_t *lines, char *filename, char **options[], char *only, int time_limit);
+
+
+
+/*
+ * Function: main
+ * --------------
+ * replays the processes file on both builds:
+ * 		replay [-t seconds] [-m minimized file] [-w work directory] [-o file] [-R "options"] reference candidate file [options]
+ * where the options are given to both builds, unless -R gives the reference options of
+ * its own (separated by spaces, "" for none). -o only compares the given file, e.g. the
+ * results file, and not the events or anything else the builds wrote. -t limits the
+ * seconds a run may take (TIME_LIMIT by default), a run which takes longer counts as a
+ * difference. The builds run in the work directory (/tmp by default).
+ *
+ * argc: argument counter, which is the number of arguments the user input
+ * argv: array containing all the arguments the user input
+ *
+ * returns: 0 if the builds wrote the same, 1 if they differ
+ */
+int main(int argc, char* argv[])
+{
+	int option;
+	int time_limit=TIME_LIMIT;
+	char *minimized=NULL; //file the cut down processes file is written into
+	char *work="/tmp";
+	char *only=NULL; //the only file compared, NULL for all of them
+	char *reference_options=NULL; //options of the reference, NULL if they are those of the candidate
+	char *split[MAX_OPTIONS+1];
+	char **options[2]; //options of the reference and of the candidate
+	char *directories[2];
+	char *binaries[2];
+	lines_t lines;
+	int same;
+	int look_up;
+
+	while ((option=getopt(argc, argv, "+t:m:w:o:R:"))!=-1){
+		if (option=='t' && atoi(optarg)>0){
+			time_limit=atoi(optarg);
+		}
+		else if (option=='m'){
+			minimized=optarg;
+		}
+		else if (option=='w'){
+			work=optarg;
+		}
+		else if (option=='o'){
+			only=optarg;
+		}
+		else if (option=='R'){
+			reference_options=optarg;
+		}
+		else{
+			optind=argc;
+		}
+	}
+	if (optind+3>argc){
+		printf("Usage: %s [-t seconds] [-m minimized file] [-w work directory] [-o file] [-R \"options\"] reference candidate file [options]\n", argv[0]);
+		exit(0);
+	}
+	options[0]=argv+optind+3;
+	options[1]=argv+optind+3;
+	if (reference_options!=NULL){
+		look_up=0;
+		split[look_up]=strtok(reference_options, " ");
+		while (split[look_up]!=NULL && look_up<MAX_OPTIONS){
+			look_up+=1;
+			split[look_up]=strtok(NULL, " ");
+		}
+		split[look_up]=NULL;
+		options[0]=split;
+	}
+	binaries[0]=realpath(argv[optind], NULL);
+	binaries[1]=realpath(argv[optind+1], NULL);
+	if (binaries[0]==NULL || binaries[1]==NULL){
+		printf("The builds could not be found\n");
+		exit(0);
+	}
+	for (look_up=0; look_up<2; look_up++){
+		directories[look_up]=malloc(strlen(work)+32);
+		if (directories[look_up]==NULL){
+			printf("There is not enough memory\n");
+			exit(0);
+		}
+		sprintf(directories[look_up], "%s/replay-XXXXXX", work);
+		if (mkdtemp(directories[look_up])==NULL){
+			printf("The work directory could not be made\n");
+			exit(0);
+		}
+	}
+
+	same=replay(binaries, directories, argv[optind+2], options, only, time_limit, 1);
+	if (!same && minimized!=NULL){
+		read_lines(argv[optind+2], &lines);
+		look_up=minimize(binaries, directories, &lines, minimized, options, only, time_limit);
+		printf("The difference shows on %d of the %d lines, written into %s:\n", look_up, lines.count, minimized);
+		replay(binaries, directories, minimized, options, only, time_limit, 1);
+	}
+	for (look_up=0; look_up<2; look_up++){
+		clean_directory(directories[look_up]);
+		rmdir(directories[look_up]);
+	}
+	exit(same ? 0 : 1);
+}
+
+/*
+ * Function: replay
+ * -------------------
+ * runs both builds on the processes file and compares what they wrote
+ *
+ * binaries: the reference and the candidate build
+ * directories: directories they run in
+ * trace: the processes file
+ * options: options given to the reference and to the candidate, each ending with NULL
+ * only: the only file compared, NULL to compare all of them
+ * time_limit: seconds a run may take
+ * report: 1 if the differences are printed out
+ *
+ * returns: 1 if the builds wrote the same, 0 otherwise
+ */
+int replay(char **binaries, char **directories, char *trace, char **options[], char *only, int time_limit, int report){
+	int status[2];
+	int look_up;
+	for (look_up=0; look_up<2; look_up++){
+		clean_directory(directories[look_up]);
+		status[look_up]=run(binaries[look_up], directories[look_up], trace, options[look_up], time_limit);
+	}
+	if (status[0]!=status[1]){
+		if (report){
+			printf("exit status: reference: %d, candidate: %d\n", status[0], status[1]);
+		}
+		return 0;
+	}
+	return compare_directories(directories, only, report);
+}
+
+/*
+ * Function: run
+ * -------------------
+ * runs the build in the directory, with the events it prints out written into
+ * events.txt there, and waits for it to finish
+ *
+ * binary: the build
+ * directory: directory it runs in
+ * trace: the processes file
+ * options: options given to it, ending with NULL
+ * time_limit: seconds it may take
+ *
+ * returns: its exit status, or -1 if it crashed or took too long
+ */
+int run(char *binary, char *directory, char *trace, char **options, int time_limit){
+	char *arguments[256];
+	char *path=realpath(trace, NULL);
+	int count=0;
+	int status;
+	pid_t pid;
+
+	if (path==NULL){
+		printf("The file could not be open. Try again\n");
+		exit(0);
+	}
+	arguments[count++]=binary;
+	while (*options!=NULL && count<254){
+		arguments[count++]=*options;
+		options+=1;
+	}
+	arguments[count++]=path;
+	arguments[count]=NULL;
+	fflush(stdout); //or the child writes out what is buffered again
+	pid=fork();
+	if (pid==0){
+		if (chdir(directory)!=0 || freopen("events.txt", "w", stdout)==NULL){
+			_exit(127);
+		}
+		alarm(time_limit); //the build is stopped once it takes too long
+		execv(binary, arguments);
+		_exit(127);
+	}
+	free(path);
+	if (pid==-1 || waitpid(pid, &status, 0)!=pid || !WIFEXITED(status)){
+		return -1;
+	}
+	return WEXITSTATUS(status);
+}
+
+/*
+ * Function: compare_directories
+ * -------------------
+ * compares the files of the directories, each of them with the file of the same name
+ * in the other one, or only the given file
+ *
+ * directories: the directories of the reference and the candidate
+ * only: the only file compared, NULL to compare all of them
+ * report: 1 if the differences are printed out
+ *
+ * returns: 1 if they have the same files with the same lines, 0 otherwise
+ */
+int compare_directories(char **directories, char *only, int report){
+	DIR *directory;
+	struct dirent *entry;
+	char *names[2]={"reference", "candidate"};
+	char path[4096];
+	int same=1;
+	int look_up;
+
+	if (only!=NULL){
+		return compare_files(directories, only, report);
+	}
+	for (look_up=0; look_up<2; look_up++){
+		directory=opendir(directories[look_up]);
+		if (directory==NULL){
+			return 0;
+		}
+		while ((entry=readdir(directory))!=NULL){
+			if (entry->d_name[0]=='.'){
+				continue;
+			}
+			/*the files of the reference are compared, the candidate may only have more of them*/
+			if (look_up==0){
+				if (!compare_files(directories, entry->d_name, report)){
+					same=0;
+				}
+				continue;
+			}
+			snprintf(path, sizeof(path), "%s/%s", directories[0], entry->d_name);
+			if (access(path, F_OK)!=0){
+				if (report){
+					printf("%s: only written by the %s\n", entry->d_name, names[1]);
+				}
+				same=0;
+			}
+		}
+		closedir(directory);
+	}
+	return same;
+}
+
+/*
+ * Function: compare_files
+ * -------------------
+ * compares the file of the reference with the file of the same name of the candidate,
+ * line by line, and prints out the first line in which they differ
+ *
+ * directories: the directories of the reference and the candidate
+ * name: name of the file
+ * report: 1 if the difference is printed out
+ *
+ * returns: 1 if the files have the same lines, 0 otherwise
+ */
+int compare_files(char **directories, char *name, int report){
+	char *names[2]={"reference", "candidate"};
+	char path[4096];
+	FILE *files[2];
+	char *lines[2]={NULL, NULL};
+	size_t capacities[2]={0, 0};
+	ssize_t lengths[2];
+	long number=0; //number of the line
+	int same=1;
+	int look_up;
+
+	for (look_up=0; look_up<2; look_up++){
+		snprintf(path, sizeof(path), "%s/%s", directories[look_up], name);
+		files[look_up]=fopen(path, "rb");
+	}
+	/*a file given with -o may be missing on either side*/
+	if (files[0]==NULL || files[1]==NULL){
+		if (report){
+			if (files[0]==NULL && files[1]==NULL){
+				printf("%s: written by neither\n", name);
+			}
+			else{
+				printf("%s: only written by the %s\n", name, names[files[0]==NULL]);
+			}
+		}
+		for (look_up=0; look_up<2; look_up++){
+			if (files[look_up]!=NULL){
+				fclose(files[look_up]);
+			}
+		}
+		return 0;
+	}
+	while (same){
+		number+=1;
+		lengths[0]=getline(&lines[0], &capacities[0], files[0]);
+		lengths[1]=getline(&lines[1], &capacities[1], files[1]);
+		if (lengths[0]==-1 && lengths[1]==-1){
+			break;
+		}
+		if (lengths[0]!=lengths[1] || memcmp(lines[0], lines[1], lengths[0])){
+			same=0;
+			for (look_up=0; look_up<2 && report; look_up++){
+				if (lengths[look_up]==-1){
+					printf("%s:%ld: %s: (end of the file)\n", name, number, names[look_up]);
+				}
+				else{
+					printf("%s:%ld: %s: %.*s", name, number, names[look_up], (int)lengths[look_up], lines[look_up]);
+					if (lines[look_up][lengths[look_up]-1]!='\n'){
+						printf("\n");
+					}
+				}
+			}
+		}
+	}
+	for (look_up=0; look_up<2; look_up++){
+		fclose(files[look_up]);
+		free(lines[look_up]);
+	}
+	return same;
+}
+
+/*
+ * Function: clean_directory
+ * -------------------
+ * removes the files the last run wrote into the directory
+ *
+ * directory: the directory
+ *
+ * returns: none
+ */
+void clean_directory(char *directory){
+	DIR *files=opendir(directory);
+	struct dirent *entry;
+	char path[4096];
+	if (files==NULL){
+		return;
+	}
+	while ((entry=readdir(files))!=NULL){
+		if (entry->d_name[0]!='.'){
+			snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+			unlink(path);
+		}
+	}
+	closedir(files);
+}
+
+/*
+ * Function: read_lines
+ * -------------------
+ * reads all the lines of the processes file, so that they can be left out one by one
+ *
+ * filename: the processes file
+ * lines: lines to be read into
+ *
+ * returns: none
+ */
+void read_lines(char *filename, lines_t *lines){
+	FILE *fp=fopen(filename, "r");
+	char *line=NULL;
+	size_t capacity=0;
+	int allocated=0;
+	if (fp==NULL){
+		printf("The file could not be open. Try again\n");
+		exit(0);
+	}
+	lines->lines=NULL;
+	lines->count=0;
+	while (getline(&line, &capacity, fp)!=-1){
+		if (lines->count==allocated){
+			allocated=allocated==0 ? 1024 : allocated*2;
+			lines->lines=realloc(lines->lines, sizeof(char *)*allocated);
+			if (lines->lines==NULL){
+				printf("There is not enough memory\n");
+				exit(0);
+			}
+		}
+		lines->lines[lines->count]=line;
+		lines->count+=1;
+		line=NULL;
+		capacity=0;
+	}
+	free(line);
+	fclose(fp);
+}
+
+/*
+ * Function: write_lines
+ * -------------------
+ * writes the lines into the file, leaving out the given ones
+ *
+ * filename: the file
+ * lines: the lines
+ * skip_start: first line left out
+ * skip_count: number of lines left out
+ *
+ * returns: none
+ */
+void write_lines(char *filename, lines_t *lines, int skip_start, int skip_count){
+	FILE *fp=fopen(filename, "w");
+	int look_up;
+	if (fp==NULL){
+		printf("The file could not be written\n");
+		exit(0);
+	}
+	for (look_up=0; look_up<lines->count; look_up++){
+		if (look_up<skip_start || look_up>=skip_start+skip_count){
+			fputs(lines->lines[look_up], fp);
+		}
+	}
+	fclose(fp);
+}
+
+/*
+ * Function: minimize
+ * -------------------
+ * cuts the lines down to as few as still show a difference between the builds: a
+ * chunk of lines is left out as long as the builds still differ without it, starting
+ * with chunks of half the lines and halving them down to single lines. The lines that
+ * are left are written into the file.
+ *
+ * binaries: the reference and the candidate build
+ * directories: directories they run in
+ * lines: lines of the processes file, which differs on the builds
+ * filename: file the lines that are left are written into
+ * options: options given to the reference and to the candidate, each ending with NULL
+ * only: the only file compared, NULL to compare all of them
+ * time_limit: seconds a run may take
+ *
+ * returns: number of the lines that are left
+ */
+int minimize(char **binaries, char **directories, lines_t *lines, char *filename, char **options[], char *only, int time_limit){
+	lines_t left=*lines;
+	int chunk=left.count/2;
+	int start;
+	int look_up;
+
+	left.lines=malloc(sizeof(char *)*(lines->count+1));
+	if (left.lines==NULL){
+		printf("There is not enough memory\n");
+		exit(0);
+	}
+	memcpy(left.lines, lines->lines, sizeof(char *)*lines->count);
+	while (chunk>=1){
+		start=0;
+		while (start<left.count){
+			write_lines(filename, &left, start, chunk);
+			if (!replay(binaries, directories, filename, options, only, time_limit, 0)){
+				/*the chunk is not needed to show the difference*/
+				for (look_up=start; look_up+chunk<left.count; look_up++){
+					left.lines[look_up]=left.lines[look_up+chunk];
+				}
+				left.count-=chunk<left.count-start ? chunk : left.count-start;
+			}
+			else{
+				start+=chunk;
+			}
+		}
+		chunk/=2;
+	}
+	write_lines(filename, &left, 0, 0);
+	free(left.lines);
+	return left.count;
+}
@@ -0,0 +1,121 @@
+#!/bin/sh
+#
+# Differential testing of the scheduler (see replay.c): builds a reference from a git
+# revision (HEAD by default) and a candidate from the working tree, and replays synthetic
+# processes files (see generate.c) on both with every policy, on 1 and 3 CPUs, with all
+# the events printed out and the results written. Anything the candidate writes
+# differently is printed out, and the processes file is cut down to the lines which
+# still show the difference, kept as minimized-[policy]-[cpus]-[seed].txt.
+#
+# The reference is only given the options it has: its usage tells which policies, -c
+# and -r it takes (without -r, neither build gets it, and both write the results file).
+# A revision without main.c is from before the policies were put in one program: its
+# fcfs.c, srtnQ3.c and deadline_based.c are built as the original programs, which take
+# nothing but the processes file, and only their results-[N].txt is compared with the
+# candidate's, on 1 CPU. Their queue holds 100 processes, and they go wrong once the CPU
+# is idle, so the files are of 99 processes, with every entry time moved back to when
+# the CPU gets free if it is later, and they are not cut down (which would make gaps).
+#
+# usage: bench/replay.sh [revision] [number of seeds]    (HEAD and 20 by default)
+# The work directory is /tmp/scheduler-replay, or REPLAY_DIR if it is set. The number of
+# processes of each file is REPLAY_COUNT (2000 by default, 99 for the original programs),
+# the policies are REPLAY_POLICIES (all of them by default; those the reference does not
+# have are skipped), and REPLAY_OPTIONS are given to both builds instead of -r both.
+
+set -e
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=${REPLAY_DIR:-/tmp/scheduler-replay}
+revision=${1:-HEAD}
+seeds=${2:-20}
+policies=${REPLAY_POLICIES:-"fcfs srtn deadline mlfq stride"}
+
+rm -rf "$work/reference"
+mkdir -p "$work/reference"
+# the program is every C file at the top of the tree, whatever the revision has
+git -C "$root" archive "$revision" | tar -x -C "$work/reference"
+gcc -O2 -pthread -o "$work/scheduler-candidate" "$root"/*.c
+gcc -O2 -o "$work/generate" "$root/bench/generate.c" -lm
+gcc -O2 -o "$work/replay" "$root/bench/replay.c"
+cd "$work"
+
+if [ -f reference/main.c ]; then
+	original=0
+	count=${REPLAY_COUNT:-2000}
+	gcc -O2 -pthread -o scheduler-reference reference/*.c
+	usage=$(./scheduler-reference -Z 2>&1 || true)
+	known=$(echo "$usage" | sed -n 's/.*\[-p \([a-z|]*\)\].*/\1/p' | head -n 1 | tr '|' ' ')
+	cpu_counts=1
+	if echo "$usage" | grep -q -- "-c cpus"; then
+		cpu_counts="1 3"
+	fi
+	options=""
+	if echo "$usage" | grep -q -- "-r lines"; then
+		options="-r both"
+	fi
+else
+	original=1
+	count=${REPLAY_COUNT:-99}
+	for program in fcfs srtnQ3 deadline_based; do
+		gcc -O2 -o "reference-$program" "reference/$program.c"
+	done
+	known="fcfs srtn deadline"
+	cpu_counts=1
+	options=""
+fi
+options=${REPLAY_OPTIONS-$options}
+
+# the policies both builds have
+chosen=""
+for policy in $policies; do
+	if echo " $known " | grep -q " $policy "; then
+		chosen="$chosen $policy"
+	else
+		echo "skipped: -p $policy, which the reference does not have"
+	fi
+done
+
+differences=0
+seed=1
+while [ "$seed" -le "$seeds" ]; do
+	# every seed has a load of its own, from an idle CPU to an overloaded one, and both kinds of deadlines
+	load=$(awk "BEGIN { print 0.5+($seed%8)*0.2 }")
+	deadlines=tight
+	if [ $((seed%2)) -eq 0 ]; then
+		deadlines=loose
+	fi
+	if [ "$original" -eq 0 ]; then
+		./generate -n "$count" -s "$seed" -u "$load" -d "$deadlines" > "trace-$seed.txt"
+	else
+		# no process enters after the CPU got free, so that the CPU is never idle
+		./generate -n "$count" -s "$seed" -u "$load" -d "$deadlines" |
+			awk 'BEGIN { free=0 } { if ($2+0>free) $2=free; free=($2+0>free ? $2+0 : free)+$3; print }' > "trace-$seed.txt"
+	fi
+	for policy in $chosen; do
+		for cpus in $cpu_counts; do
+			if [ "$original" -eq 0 ]; then
+				cpu_option=""
+				if [ "$cpu_counts" != 1 ]; then
+					cpu_option="-c $cpus"
+				fi
+				if ./replay -m "minimized-$policy-$cpus-$seed.txt" ./scheduler-reference ./scheduler-candidate \
+					"trace-$seed.txt" -p "$policy" $cpu_option $options; then
+					continue
+				fi
+			else
+				case $policy in
+					fcfs) program=fcfs; number=1;;
+					srtn) program=srtnQ3; number=2;;
+					deadline) program=deadline_based; number=3;;
+				esac
+				if ./replay -t 10 -R "" -o "results-$number.txt" "./reference-$program" ./scheduler-candidate \
+					"trace-$seed.txt" -p "$policy" $options; then
+					continue
+				fi
+			fi
+			echo "differs: -p $policy -c $cpus, seed $seed (load $load, $deadlines deadlines)"
+			differences=$((differences+1))
+		done
+	done
+	seed=$((seed+1))
+done
+echo "$differences differences"
@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Benchmarks the policies on synthetic processes files (see generate.c).
+# For every size and both kinds of deadlines, a file is generated (once, it is kept in
+# the work directory) and every policy is run on it with all the events printed out.
+# A line is printed out per run with the wall time, the events, the events per second,
+# the peak RSS and the bytes written.
+#
+# usage: bench/run.sh [number of processes ...]    (1000 10000 100000 1000000 by default)
+# The work directory is /tmp/scheduler-bench, or BENCH_DIR if it is set.
+
+set -e
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=${BENCH_DIR:-/tmp/scheduler-bench}
+sizes=${*:-"1000 10000 100000 1000000"}
+
+mkdir -p "$work"
+gcc -O2 -pthread -o "$work/scheduler" "$root/main.c" "$root/scheduler.c" "$root/fcfs.c" "$root/srtnQ3.c" \
+	"$root/deadline_based.c" "$root/mlfq.c" "$root/stride.c" "$root/sweep.c" "$root/small_queue.c" "$root/metrics.c" "$root/trace.c" \
+	"$root/checkpoint.c" "$root/service.c" "$root/timing_wheel.c" "$root/sort.c" "$root/shard.c"
+gcc -O2 -o "$work/generate" "$root/bench/generate.c" -lm
+gcc -O2 -o "$work/bench" "$root/bench/bench.c"
+
+cd "$work"
+printf "%-9s %9s %-9s %10s %12s %14s %12s %14s\n" policy processes deadlines seconds events events/s peak_rss_kb output_bytes
+for count in $sizes; do
+	for deadlines in tight loose; do
+		trace="trace-$count-$deadlines.txt"
+		if [ ! -f "$trace" ]; then
+			./generate -n "$count" -d "$deadlines" > "$trace"
+		fi
+		number=1
+		for policy in fcfs srtn deadline mlfq stride; do
+			printf "%-9s %9s %-9s " "$policy" "$count" "$deadlines"
+			./bench -o "results-$number.txt" ./scheduler -p "$policy" "$trace"
+			number=$((number+1))
+		done
+	done
+done
@@ -0,0 +1,423 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Checkpoints: the full state of a simulation saved into a file while it runs, so that
+ * a long simulation which was stopped can go on from the last checkpoint rather than
+ * from the start. The checkpoint file holds:
+ *
+ *		header (checkpoint_header_t): the options, the clock, the next process, how far
+ *			the file with processes was read, the sizes of the output and the totals
+ *		process table, one column after another (rear places each)
+ *		bitmap of the places which hold a process
+ *		places to be reused (free_count ints)
+ *		CPUs (cpus cpu_t)
+ *		sketches of the wait and turnaround times
+ *		run queues of the policy, if it saves them
+ *
+ * in the byte order of the machine that wrote it. The run queues of most policies are not
+ * saved: every waiting process knows the CPU whose run queue it is in, and putting the
+ * processes back in order of arrival gives the policy run queues which choose the same
+ * processes. A policy whose run queues depend on more than that (MLFQ, stride) saves them itself.
+ * Only the places which were ever used are saved, so the checkpoint grows
+ * with the number of processes in the system at the same time, not with the file.
+ *
+ * The checkpoint is written into another file first, which then replaces the old one,
+ * so that there is always a whole checkpoint to go on from.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* memcmp, memcpy, strncpy */
+#include <time.h>       /* clock_gettime */
+#include <unistd.h>     /* fsync, ftruncate, lseek */
+#include <sys/stat.h>   /* fstat */
+#include "scheduler.h"
+#define CHECKPOINT_MAGIC "SCHCKPNT" //first bytes of a checkpoint file
+#define CHECKPOINT_VERSION 5 //version of the checkpoint format
+
+/* Header of a checkpoint file*/
+typedef struct{
+	char magic[8]; //CHECKPOINT_MAGIC
+	unsigned int version; //CHECKPOINT_VERSION, in the byte order of the machine that wrote it
+	char policy[16]; //name of the policy
+	int quantum; //quantum of the simulation
+	int cpus; //number of the CPUs
+	int switch_cost; //seconds a CPU spends on a context switch
+	int migration_cost; //seconds it spends on top of that on a migration
+	format_t format; //format of the results file
+	int fair_share; //1 if the share deviation of the processes is reported
+	int clock; //current time
+	int pending; //1 if the next process was read but has not entered yet
+	int repeat; //1 if the current second is gone through once more (legacy timing)
+	pcb_t next; //the next process
+	long input_offset; //characters of the file which were read, -1 if the processes are taken from the trace
+	int trace_position; //position of the next process in the trace
+	int trace_count; //number of processes in the trace
+	long results_offset; //size of the results file, -1 if there is none
+	long log_offset; //size of the file the events are printed out to, -1 if it is not a file
+	int capacity; //number of places allocated for the queue
+	int rear; //points after the last place of the queue that was ever used
+	int free_count; //number of places to be reused
+	int arrivals; //number of processes that entered the system
+	long finished; //number of finished processes
+	long total_wait; //sum of the wait times
+	long total_turnaround; //sum of the turnaround times
+	long deadlines_met; //number of processes which met the deadline
+	long total_tickets; //tickets of the processes in the system
+	double fair_time; //CPU seconds a single ticket was entitled to since the start
+	double total_deviation; //sum of the share deviations, as absolute values
+	double max_deviation; //biggest share deviation, as an absolute value
+} checkpoint_header_t;
+
+/* Waiting process, as it is put back into the run queue*/
+typedef struct{
+	int arrival; //order in which the process entered the system
+	int place; //place of the process in the queue
+} waiting_t;
+
+/*functions*/
+static double wall_time(void);
+static int by_arrival(const void *first, const void *second);
+
+
+/*
+ * Function: wall_time
+ * -------------------
+ * finds the wall time
+ *
+ * returns: seconds since some moment in the past
+ */
+static double wall_time(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec+now.tv_nsec/1e9;
+}
+
+/*
+ * Function: checkpoint_due
+ * -------------------
+ * checks whether the interval since the last checkpoint (or the first look at the wall
+ * time) is over. It is only called every CHECKPOINT_STEPS steps of the simulation.
+ *
+ * sim: the simulation
+ *
+ * returns: 1 if the state is to be saved, 0 otherwise
+ */
+int checkpoint_due(simulation_t *sim){
+	double now=wall_time();
+	if (sim->next_checkpoint==0){
+		sim->next_checkpoint=now+sim->checkpoint_interval;
+		return sim->checkpoint_interval==0;
+	}
+	if (now<sim->next_checkpoint){
+		return 0;
+	}
+	sim->next_checkpoint=now+sim->checkpoint_interval;
+	return 1;
+}
+
+/*
+ * Function: write_checkpoint
+ * -------------------
+ * saves the state of the simulation into the checkpoint file. The events so far are
+ * printed out and the results file is written out first, so that the checkpoint knows
+ * where the output ends. The state of the loop (the clock and the next process) is
+ * to be put into the simulation before.
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+void write_checkpoint(simulation_t *sim){
+	checkpoint_header_t header;
+	process_table_t *queue=&sim->queue;
+	char *temporary=malloc(strlen(sim->checkpoint)+5); //file the checkpoint is written into first
+	FILE *fp;
+	int failed;
+
+	if (temporary==NULL){
+		out_of_memory(sim);
+	}
+	flush_log(sim);
+	memset(&header, 0, sizeof(checkpoint_header_t));
+	memcpy(header.magic, CHECKPOINT_MAGIC, 8);
+	header.version=CHECKPOINT_VERSION;
+	strncpy(header.policy, sim->policy->name, sizeof(header.policy)-1);
+	header.quantum=sim->quantum;
+	header.cpus=sim->cpus;
+	header.switch_cost=sim->switch_cost;
+	header.migration_cost=sim->migration_cost;
+	header.format=sim->format;
+	header.fair_share=sim->fair_share;
+	header.clock=sim->clock;
+	header.pending=sim->pending;
+	header.repeat=sim->repeat;
+	header.next=sim->next;
+	header.input_offset=-1;
+	if (sim->reader!=NULL){
+		header.input_offset=sim->reader->offset+sim->reader->position;
+	}
+	else{
+		header.trace_position=sim->trace_position;
+		header.trace_count=sim->trace->count;
+	}
+	header.results_offset=-1;
+	if (sim->results!=NULL && fflush(sim->results)==0){
+		header.results_offset=ftell(sim->results);
+	}
+	header.log_offset=lseek(STDOUT_FILENO, 0, SEEK_CUR);
+	header.capacity=sim->capacity;
+	header.rear=sim->rear;
+	header.free_count=sim->free_count;
+	header.arrivals=sim->arrivals;
+	header.finished=sim->finished;
+	header.total_wait=sim->total_wait;
+	header.total_turnaround=sim->total_turnaround;
+	header.deadlines_met=sim->deadlines_met;
+	header.total_tickets=sim->total_tickets;
+	header.fair_time=sim->fair_time;
+	header.total_deviation=sim->total_deviation;
+	header.max_deviation=sim->max_deviation;
+
+	sprintf(temporary, "%s.tmp", sim->checkpoint);
+	fp=fopen(temporary, "wb");
+	if (fp==NULL){
+		printf("The checkpoint file could not be open. Try again");
+		exit(0);
+	}
+	fwrite(&header, sizeof(checkpoint_header_t), 1, fp);
+	fwrite(queue->remainingTime, sizeof(int), sim->rear, fp);
+	fwrite(queue->entryTime, sizeof(int), sim->rear, fp);
+	fwrite(queue->deadline, sizeof(int), sim->rear, fp);
+	fwrite(queue->serviceTime, sizeof(int), sim->rear, fp);
+	fwrite(queue->tickets, sizeof(int), sim->rear, fp);
+	fwrite(queue->share_start, sizeof(double), sim->rear, fp);
+	fwrite(queue->execTime, sizeof(int), sim->rear, fp);
+	fwrite(queue->arrival, sizeof(int), sim->rear, fp);
+	fwrite(queue->cpu, sizeof(int), sim->rear, fp);
+	fwrite(queue->run_queue, sizeof(int), sim->rear, fp);
+	fwrite(queue->processname, NAME_SIZE, sim->rear, fp);
+	fwrite(queue->live, sizeof(unsigned long), sim->capacity/WORD_BITS, fp);
+	fwrite(sim->free_places, sizeof(int), sim->free_count, fp);
+	fwrite(sim->cpu, sizeof(cpu_t), sim->cpus, fp);
+	fwrite(&sim->wait_times, sizeof(sketch_t), 1, fp);
+	fwrite(&sim->turnaround_times, sizeof(sketch_t), 1, fp);
+	if (sim->policy->save!=NULL){
+		sim->policy->save(sim, fp);
+	}
+	/*the checkpoint is on the disk before it replaces the old one*/
+	failed=fflush(fp)!=0 || ferror(fp) || fsync(fileno(fp))!=0;
+	if (fclose(fp)!=0 || failed || rename(temporary, sim->checkpoint)!=0){
+		printf("The checkpoint file could not be written");
+		exit(0);
+	}
+	free(temporary);
+}
+
+/*
+ * Function: read_part
+ * -------------------
+ * reads a part of the checkpoint file, stopping the program if the file ends before it.
+ * It is also used by the policies which load their run queues from the checkpoint.
+ *
+ * fp: the checkpoint file
+ * part: where the part is read into
+ * size: size of an element
+ * count: number of elements
+ *
+ * returns: none
+ */
+void read_part(FILE *fp, void *part, size_t size, size_t count){
+	if (fread(part, size, count, fp)!=count){
+		printf("The checkpoint file is damaged");
+		exit(0);
+	}
+}
+
+/*
+ * Function: read_checkpoint
+ * -------------------
+ * loads the state of the simulation from the checkpoint file, so that simulate() goes
+ * on from it. The simulation is to be prepared with the same options and the same file
+ * with processes as when the checkpoint was saved; the file is read from where the
+ * checkpoint left it, so it cannot be a pipe. If the events are printed out into a file
+ * which is not shorter than it was at the checkpoint, the events printed out after the
+ * checkpoint are cut off it.
+ *
+ * sim: the simulation
+ * filename: name of the checkpoint file
+ *
+ * returns: none
+ */
+void read_checkpoint(simulation_t *sim, char *filename){
+	checkpoint_header_t header;
+	process_table_t *queue=&sim->queue;
+	struct stat output;
+	int place;
+	FILE *fp=fopen(filename, "rb");
+
+	if (fp==NULL){
+		printf("The checkpoint file could not be open. Try again");
+		exit(0);
+	}
+	read_part(fp, &header, sizeof(checkpoint_header_t), 1);
+	if (memcmp(header.magic, CHECKPOINT_MAGIC, 8)){
+		printf("The checkpoint file is damaged");
+		exit(0);
+	}
+	if (header.version!=CHECKPOINT_VERSION){
+		printf("The checkpoint file was written by another version or on a machine with another byte order");
+		exit(0);
+	}
+	if (strncmp(header.policy, sim->policy->name, sizeof(header.policy)) || header.quantum!=sim->quantum ||
+		header.cpus!=sim->cpus || header.switch_cost!=sim->switch_cost || header.migration_cost!=sim->migration_cost ||
+		header.format!=sim->format || header.fair_share!=sim->fair_share){
+		printf("The checkpoint was saved with other options");
+		exit(0);
+	}
+	if ((header.input_offset==-1)!=(sim->reader==NULL) || (sim->reader==NULL && header.trace_count!=sim->trace->count)){
+		printf("The checkpoint was saved with another file");
+		exit(0);
+	}
+	if (header.capacity<0 || header.rear<0 || header.rear>header.capacity || header.free_count<0 || header.free_count>header.rear){
+		printf("The checkpoint file is damaged");
+		exit(0);
+	}
+
+	/*the file with processes is read from where the checkpoint left it*/
+	if (sim->reader!=NULL){
+		if (fseek(sim->reader->fp, header.input_offset, SEEK_SET)!=0){
+			printf("The processes cannot be read from the checkpoint on, since the file is a pipe");
+			exit(0);
+		}
+		sim->reader->offset=header.input_offset;
+		sim->reader->size=0;
+		sim->reader->position=0;
+	}
+	else{
+		sim->trace_position=header.trace_position;
+	}
+
+	while (sim->capacity<header.capacity){
+		grow_queue(sim);
+	}
+	if (sim->capacity!=header.capacity){
+		printf("The checkpoint file is damaged");
+		exit(0);
+	}
+	sim->rear=header.rear;
+	sim->free_count=header.free_count;
+	sim->arrivals=header.arrivals;
+	read_part(fp, queue->remainingTime, sizeof(int), sim->rear);
+	read_part(fp, queue->entryTime, sizeof(int), sim->rear);
+	read_part(fp, queue->deadline, sizeof(int), sim->rear);
+	read_part(fp, queue->serviceTime, sizeof(int), sim->rear);
+	read_part(fp, queue->tickets, sizeof(int), sim->rear);
+	read_part(fp, queue->share_start, sizeof(double), sim->rear);
+	read_part(fp, queue->execTime, sizeof(int), sim->rear);
+	read_part(fp, queue->arrival, sizeof(int), sim->rear);
+	read_part(fp, queue->cpu, sizeof(int), sim->rear);
+	read_part(fp, queue->run_queue, sizeof(int), sim->rear);
+	read_part(fp, queue->processname, NAME_SIZE, sim->rear);
+	read_part(fp, queue->live, sizeof(unsigned long), sim->capacity/WORD_BITS);
+	read_part(fp, sim->free_places, sizeof(int), sim->free_count);
+	/*the heaps of the policies are built again*/
+	for (place=0; place<sim->rear; place++){
+		queue->heap_place[place]=-1;
+	}
+	sim->cpu=calloc(sim->cpus, sizeof(cpu_t));
+	if (sim->cpu==NULL){
+		out_of_memory(sim);
+	}
+	read_part(fp, sim->cpu, sizeof(cpu_t), sim->cpus);
+	read_part(fp, &sim->wait_times, sizeof(sketch_t), 1);
+	read_part(fp, &sim->turnaround_times, sizeof(sketch_t), 1);
+	/*the run queues of the policy are loaded once they are created (see restore_run_queues())*/
+	sim->resume_file=fp;
+
+	sim->clock=header.clock;
+	sim->pending=header.pending;
+	sim->repeat=header.repeat;
+	sim->next=header.next;
+	sim->results_offset=header.results_offset;
+	sim->finished=header.finished;
+	sim->total_wait=header.total_wait;
+	sim->total_turnaround=header.total_turnaround;
+	sim->deadlines_met=header.deadlines_met;
+	sim->total_tickets=header.total_tickets;
+	sim->fair_time=header.fair_time;
+	sim->total_deviation=header.total_deviation;
+	sim->max_deviation=header.max_deviation;
+	sim->resumed=1;
+
+	/*the events printed out after the checkpoint are printed out again*/
+	if (header.log_offset>=0 && fstat(STDOUT_FILENO, &output)==0 && S_ISREG(output.st_mode) && output.st_size>=header.log_offset){
+		fflush(stdout);
+		if (ftruncate(STDOUT_FILENO, header.log_offset)==0){
+			lseek(STDOUT_FILENO, header.log_offset, SEEK_SET);
+		}
+	}
+}
+
+/*
+ * Function: by_arrival
+ * -------------------
+ * compares two waiting processes by the order in which they entered the system (for qsort)
+ *
+ * first: the first process
+ * second: the second process
+ *
+ * returns: negative if the first one entered first, positive otherwise
+ */
+static int by_arrival(const void *first, const void *second){
+	return ((const waiting_t *)first)->arrival-((const waiting_t *)second)->arrival;
+}
+
+/*
+ * Function: restore_run_queues
+ * -------------------
+ * puts the waiting processes of a resumed simulation back into the run queues of their
+ * CPUs, in the order in which they entered the system. The policies keep their run queues
+ * in order of arrival or by keys which do not change while the processes wait, so the
+ * run queues choose the same processes as the ones which were saved. A policy which saved
+ * its run queues loads them instead. The run queues are to be created by the policy before.
+ *
+ * sim: the simulation
+ * time: current time
+ *
+ * returns: none
+ */
+void restore_run_queues(simulation_t *sim, int time){
+	process_table_t *queue=&sim->queue;
+	waiting_t *waiting;
+	int count=0;
+	int place;
+	int look_up;
+
+	if (sim->policy->load!=NULL){
+		sim->policy->load(sim, sim->resume_file);
+	}
+	fclose(sim->resume_file);
+	sim->resume_file=NULL;
+	if (sim->policy->load!=NULL){
+		return;
+	}
+	waiting=malloc(sizeof(waiting_t)*(sim->rear>0 ? sim->rear : 1));
+	if (waiting==NULL){
+		out_of_memory(sim);
+	}
+	for (place=0; place<sim->rear; place++){
+		if (IS_LIVE(queue, place) && queue->run_queue[place]>=0 && queue->run_queue[place]<sim->cpus){
+			waiting[count].arrival=queue->arrival[place];
+			waiting[count].place=place;
+			count+=1;
+		}
+	}
+	qsort(waiting, count, sizeof(waiting_t), by_arrival);
+	for (look_up=0; look_up<count; look_up++){
+		place=waiting[look_up].place;
+		sim->policy->on_arrival(sim, queue->run_queue[place], place, time);
+	}
+	free(waiting);
+}
@@ -3,416 +3,429 @@
  * Start date: 01/10/2021
  * Last modified: 08/08/2021
  * -------------------------
- * 
- * The following application is a simulation of the preemptive deadline-driven(q=1) scheduling 
- * algorithm. It gets the information about each process from the file, where each
- * line represents a singe process in form of:
- * 		[Process Name] [Arrival Time] [Service Time] [Deadline]. 
- *  It schedules the processes accordingly (choosing the process, which is still  
- *  able to end processing within the deadline and which is going to reach the deadline
- *	the fastest; if there is no process like that, works as FCFS) and then prints out the main events:
- *		- when the new process enters
- *		- when any of the processes finishes execution
- *		- which process is currently running ( when any of the events above happen)
- *
- * Moreover, it saves information about each of the processes into results-3.txt
- * in form of:
- * 		[Process name] [Wait time] [Turnaround Time] [Deadline Met]
+ *
+ * The following is the preemptive deadline-driven(q=1) scheduling policy for the
+ * simulation core (see scheduler.c). It schedules the processes accordingly (choosing
+ * the process, which is still able to end processing within the deadline and which is
+ * going to reach the deadline the fastest; if there is no process like that, works as FCFS).
+ *
+ * While only a few processes wait for a CPU, they are kept in a small queue searched
+ * all at once (see small_queue.c); once there are more, they are kept in heaps, and the
+ * time at which each of the long ones can no longer meet its deadline is kept in a timing
+ * wheel (see timing_wheel.c), so that it is moved out of the way right then.
+ *
+ * The results are saved into results-3.txt.
  */
-#include <stdio.h>      /* standard I/O routines */
-#include <stdlib.h>     /* needed for exit function */
-#include <string.h>     /* string operations */
-#define MAX 100
 
+#include <stdlib.h>     /* calloc */
+#include "scheduler.h"
 
+/* Run queue of a CPU: the small queue while few processes wait, the heaps otherwise*/
+typedef struct{
+	small_queue_t small; //processes in order of arrival, by absolute deadline, deadline and latest start
+	heap_t deadlines; //processes, which can still meet the deadline, ordered by their absolute deadline
+	heap_t overdue; //processes, which can no longer meet the deadline, ordered by arrival (FCFS)
+	int in_heap; //1 while the processes are in the heaps
+} run_queue_t;
 
-/*Special enumerated data type for process state*/
-typedef enum {
-	READY, RUNNING, EXIT
-} process_state_t;
-
-/* C data structure used as process control block. The scheduler should create
-one instance per running process in the system*/
+/* Run queues of the CPUs and the timers of the processes in their heaps*/
 typedef struct{
-	char processname[11]; // A string that identifies the process
-	
-	/*Times are measured in seconds*/
-	int entryTime; // The time process enteres system
-	int serviceTime; //The total CPU time required by the process
-	int remainingTime; //Remaining service time until completion 
-	int deadline; //The expected turnaround time
-	int execTime; //The time when process started execution
-	process_state_t state; //current process state(e.g. READY)
-} pcb_t;
+	timing_wheel_t wheel; //time at which the processes with a timer in the heaps of deadlines become overdue
+	run_queue_t run_queues[]; //run queue of every CPU
+} deadline_t;
 
-/*global variables*/
-int rear= 0;  //points at the last inserted process
-pcb_t queue[MAX];
 /*functions*/
-void add_empty(int count);
-void insert();
-void fill_empy_process();
-void new_process(FILE *fp, int total_processes);
-void remaining_processes(int time, int total_processes, int q, int process_to_run);
-int add_empty_processes(FILE *fp);
-void summarize (pcb_t process, int time);
-int find_next(int time);
-void clear_output_file();
+static int is_feasible(simulation_t *sim, int place, int time);
+static int is_before_deadline(simulation_t *sim, int first, int second);
+static int is_before_arrival(simulation_t *sim, int first, int second);
+static void deadline_on_start(simulation_t *sim);
+static void deadline_on_arrival(simulation_t *sim, int cpu, int place, int time);
+static int deadline_select_next(simulation_t *sim, int cpu, int time, int running);
+static void deadline_on_preempt(simulation_t *sim, int cpu, int place, int time);
+static void deadline_on_end(simulation_t *sim);
+static void small_add(simulation_t *sim, small_queue_t *small, int place);
+static void heap_add(simulation_t *sim, run_queue_t *run_queue, int place);
+static void to_heap(simulation_t *sim, run_queue_t *run_queue);
+static void to_small(simulation_t *sim, run_queue_t *run_queue);
+static int latest_start(simulation_t *sim, int place);
+static void cancel_timer(simulation_t *sim, int place);
+
+policy_t deadline_policy={"deadline", 3, 1, 0, 0, deadline_on_start, deadline_on_arrival, deadline_select_next, deadline_on_preempt, NULL, deadline_on_end, NULL, NULL, NULL};
+
 
 /*
- * Function: main 
- * --------------
- * opens the file for reading from it, checking whether the user input is valid. 
- * if the user did not specify the file to read from, opens the default "processes.txt",
- * otherwise opens the specified file. 
+ * Function: is_feasible
+ * -------------------
+ * Checks whether the process can still complete executing within the deadline:
+ * its gap is positive and not smaller than its remaining time, where
+ * gap = deadline - (time - entry time)
  *
- * calls the clear_output_file() function to clear the "results-3.txt" file
+ * sim: the simulation
+ * place: place of the process in the queue
+ * time: current time
  *
- * calls the add_empty_processes() function to initialize all the processes with default numbers
+ * returns: 1 if the process can still meet the deadline, 0 otherwise
+ */
+static int is_feasible(simulation_t *sim, int place, int time){
+	process_table_t *queue=&sim->queue;
+	/* Find the how many seconds are there before the process passes the deadline*/
+	int gap=queue->deadline[place]-(time-queue->entryTime[place]);
+	return queue->remainingTime[place]<=gap && gap>0;
+}
+
+/*
+ * Function: is_before_deadline
+ * -------------------
+ * Checks whether the first process has smaller gap (absolute deadline) than the second one.
+ * If two processes have the same gap, the one with smaller deadline goes first, since
+ * it's most likely to be reached faster. If the deadlines are the same too, the one
+ * which entered the system first goes first.
  *
- * calls the scheduling functions to schedule the processes with SRTN(q=3) approach
+ * sim: the simulation
+ * first: place of the first process in the queue
+ * second: place of the second process in the queue
  *
- * argc: argument counter, which is the number of arguments the user input
- * argv: array containing all the arguments the user input 
- * 
- * returns: none
+ * returns: 1 if the first process goes before the second one, 0 otherwise
  */
-int main(int argc, char* argv[])
-{
-	/*open files*/
-	FILE *fp;
-	if (argc>1){
-		fp = fopen (argv[1], "r");
-	}
-	else{
-		fp = fopen ("processes.txt", "r");
+static int is_before_deadline(simulation_t *sim, int first, int second){
+	process_table_t *queue=&sim->queue;
+	int first_end=queue->entryTime[first]+queue->deadline[first];
+	int second_end=queue->entryTime[second]+queue->deadline[second];
+	if (first_end!=second_end){
+		return first_end<second_end;
 	}
-	
-	/*handling the non-existent file*/
-	if (fp==NULL){
-		printf("The file could not be open. Try again");
-		exit(0); 
+	if (queue->deadline[first]!=queue->deadline[second]){
+		return queue->deadline[first]<queue->deadline[second];
 	}
-	
-	/*clear the output file*/
-	clear_output_file();
-	
-	/*initialize time*/
-	int time=0;
-	int total_processes;
-	/*counting number of lines in the file and adding and empty processes to the queue
-	for each line*/
-	total_processes=add_empty_processes(fp);
-	
-	/*adding processes and working on them*/
-	new_process(fp, total_processes);
-	
-	fclose(fp);
-	exit(0); 
+	return queue->arrival[first]<queue->arrival[second];
 }
 
 /*
- * Function: clear_output_file
+ * Function: is_before_arrival
  * -------------------
- * clears the content of the "results-3.txt" file
+ * Checks whether the first process entered the system before the second one
  *
- * returns: none
+ * sim: the simulation
+ * first: place of the first process in the queue
+ * second: place of the second process in the queue
+ *
+ * returns: 1 if the first process goes before the second one, 0 otherwise
  */
-void clear_output_file(){
-	fclose(fopen("results-3.txt", "w"));
+static int is_before_arrival(simulation_t *sim, int first, int second){
+	return sim->queue.arrival[first]<sim->queue.arrival[second];
 }
 
 /*
- * Function: insert
+ * Function: deadline_on_start
  * -------------------
- * inserts the process into the queue, checking whether total number does not excess the
- * limitation. Places the rear pointer at the last inserted process.
- * 
- * process: the instance of pcb_t struct, which is to be inserted
+ * creates empty heaps for every CPU of the simulation and an empty timing wheel
+ *
+ * sim: the simulation
  *
  * returns: none
  */
-void insert(pcb_t process){
-	if (rear == MAX - 1){
-		printf("The number of processes is exceeding the limit");
-		return;
+static void deadline_on_start(simulation_t *sim){
+	deadline_t *deadline=calloc(1, sizeof(deadline_t)+sizeof(run_queue_t)*sim->cpus);
+	run_queue_t *run_queues;
+	int look_up;
+	if (deadline==NULL){
+		out_of_memory(sim);
 	}
-	else{
-		queue[rear]= process;
-		rear=rear+1;
+	run_queues=deadline->run_queues;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		run_queues[look_up].deadlines.is_before=is_before_deadline;
+		run_queues[look_up].deadlines.sim=sim;
+		run_queues[look_up].overdue.is_before=is_before_arrival;
+		run_queues[look_up].overdue.sim=sim;
 	}
+	wheel_init(&deadline->wheel);
+	sim->policy_data=deadline;
 }
 
 /*
- * Function: add_empty
+ * Function: deadline_on_end
  * -------------------
- * adds the process with all the default attributes to the given position
+ * frees the heaps and the timing wheel of the simulation
  *
- * count: position of the process to be deleted
+ * sim: the simulation
  *
  * returns: none
  */
-void add_empty(int count){
-	pcb_t process; 
-	strcpy(process.processname, "-1");
-	process.entryTime= -1;
-	process.serviceTime =-1;
-	process.remainingTime=-1;
-	process.execTime=-1;
-	queue[count]= process;
+static void deadline_on_end(simulation_t *sim){
+	deadline_t *deadline=sim->policy_data;
+	run_queue_t *run_queues=deadline->run_queues;
+	int look_up;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		small_free(&run_queues[look_up].small);
+		free(run_queues[look_up].deadlines.places);
+		free(run_queues[look_up].overdue.places);
+	}
+	wheel_free(&deadline->wheel);
+	free(deadline);
+	sim->policy_data=NULL;
 }
 
 /*
- * Function: new_process
+ * Function: deadline_on_arrival
  * -------------------
- * works on scheduling the processes, when there are processes that are NOT read from the
- * file. reads the file line by line, inserting the processes to the queue at their 
- * entry time, while allowing other process to run
+ * adds the process to the small queue of the CPU or, once it is full, to the heaps
+ * (see heap_add())
  *
- * fp: file to be read from
- * total_processes: total number of processes to be inserted
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
  *
  * returns: none
  */
-void new_process(FILE *fp, int total_processes){
-	/* initialization*/
-	pcb_t process;
-	size_t len = 128; //maximum length of line is 128 char
-	char *line= malloc(sizeof(char)*len); //allocating space
-	int time=0; //current time in seconds
-	int inserted; // shows whether the character was inserted or not
-	int q=0; //quantum counter
-	int process_to_run;
-	
-	while (fgets(line, len, fp)!=NULL){ //while there is a line in the file to be read
-		/*reading new line into process*/
-		sscanf (line, "%10s%d%d%d", process.processname, &process.entryTime, &process.serviceTime, &process.deadline);
-		process.remainingTime=process.serviceTime;
-		inserted=0; //reinitializing to 0 for every new line
-		
-		while (inserted==0){
-			queue[rear].state=READY; // process is in a ready state once inserted
-			
-			/*insert the process once the time reaches it's enrty time*/
-			if (process.entryTime <= time){
-				insert(process); 
-				printf("Time %d: %10s has entered the system\n", process.entryTime, process.processname );
-				inserted = 1; //shows that it was inserted
-			}
-			
-			//each second, the new process is being searched for 
-			if (q==1){
-				q=0;
-			}
-			
-			//if the quantum is 0 or the current process is completed
-			if (q==0 || !strcmp(queue[process_to_run].processname, "-1" )){
-				process_to_run=find_next(time);  //search for the next process
-				queue[process_to_run].state=RUNNING;
-			}
-			
-			//once the process started running for the 1st time, its exec time is recorded
-			if( queue[process_to_run].remainingTime== queue[process_to_run].serviceTime){
-				queue[process_to_run].execTime=time;
-			}
-					
-			if (strcmp(process.processname,queue[process_to_run].processname )){
-				printf("Time %d: %10s is in the running state\n", time, queue[process_to_run].processname );
-			}
-			
-			/*deduct one second, if remaining time is more than 0*/
-			if (queue[process_to_run].remainingTime!=0){
-				queue[process_to_run].remainingTime-=1;
-			}
-			
-			//increment of the time and quantum
-			time+=1;
-			q+=1;
-			
-			/*once remaining time is 0, process has finished the execution*/
-			if (queue[process_to_run].remainingTime==0){
-				queue[process_to_run].state=EXIT;
-				printf("Time %d: %10s has finished execution\n", time, queue[process_to_run].processname);
-				summarize(queue[process_to_run], time);
-				add_empty(process_to_run); //process is removed from the queue
-				total_processes-=1; //since the process is deleted the total number of processes to be processed is decreased
-				if (strcmp(queue[process_to_run].processname, "-1")){
-					printf("Time %d: %10s is in the running state\n", time, queue[process_to_run].processname );
-				}
-				q=0; //reset quantum to 0, once the process is deleted
-			}
-		}
+static void deadline_on_arrival(simulation_t *sim, int cpu, int place, int time){
+	run_queue_t *run_queue=((deadline_t *)sim->policy_data)->run_queues+cpu;
+	if (!run_queue->in_heap && run_queue->small.size==SMALL_QUEUE_SIZE){
+		to_heap(sim, run_queue);
+	}
+	if (run_queue->in_heap){
+		heap_add(sim, run_queue, place);
+	}
+	else{
+		small_add(sim, &run_queue->small, place);
 	}
-	free(line); //empty allocated space
-	
-	/*after all the processes are added, work on the processes which remain in the system*/
-	remaining_processes(time, total_processes, q, process_to_run);
 }
 
-
 /*
- * Function: remaining_processes
- * ------------------------------
- * works on scheduling the processes, when ALL the processes are read from the
- * file. works on the remaining processes, scheduling them according to deadline driven(q=1) algorithm
+ * Function: deadline_select_next
+ * -------------------
+ * Finds the process which is most likely to reach its deadline from the running process
+ * and the run queue of the CPU. If all the processes are over the deadline, works based 
+ * on FCFS algorithm.
  *
- * time: time which the new_process() stopped running at
- * total_processe: number of processes in the system awaiting to be processed
- * process_to_run: process that was in a state of running
+ * Since the gaps of all the processes decrease at the same pace, the order of the
+ * processes by gap is the same as by their absolute deadline (entry time + deadline),
+ * which does not change with time. The waiting processes are therefore kept in a heap
+ * ordered by it. A process, which can no longer finish within the deadline, never
+ * becomes able to again, so it is moved to the heap of overdue processes, ordered by
+ * arrival, once it reaches the top of the heap. A process with a lot left to run
+ * may pass its latest start long before it reaches the top, and stay in the way of
+ * the others until then, so it is moved once its timer in the timing wheel expires
+ * instead (see heap_add()). The running process is kept out of both heaps and is
+ * compared with the tops of them.
  *
- * returns: none
+ * In the small queue, the process is the first one with the smallest absolute deadline
+ * and deadline, of the ones which are still before their latest start. If there is
+ * none, all the waiting processes are overdue, and the first one of them arrived first.
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * time: time, right at the moment when the process is being searched for
+ * running: process that is in a state of running (-1 if none)
+ *
+ * returns: the process to run, -1 if there are no processes
  */
-void remaining_processes(int time, int total_processes, int q, int process_to_run){
-	/*works on the remaining processes*/
-	while(total_processes>0){ 
-		//each second, the new process is being searched for 
-		if (q==1){
-			q=0;
-		}
-		//if the quantum is 0 or the current process is completed
-		if (q==0 || !strcmp(queue[process_to_run].processname, "-1" )){
-			process_to_run=find_next(time); //search for the next process
-			queue[process_to_run].state=RUNNING;
+static int deadline_select_next(simulation_t *sim, int cpu, int time, int running){
+	deadline_t *deadline=sim->policy_data;
+	run_queue_t *run_queue=deadline->run_queues+cpu;
+	small_queue_t *small=&run_queue->small;
+	heap_t *feasible=&run_queue->deadlines;
+	heap_t *late=&run_queue->overdue;
+	run_queue_t *expired; //run queue of the process which passed its latest start
+	int position;
+	int place;
+	/*moving the processes which passed their latest start, on any CPU, out of the way (the wheel is not looked at before anything is due)*/
+	while (time>=deadline->wheel.due && (place=wheel_expire(&deadline->wheel, time))!=-1){
+		expired=deadline->run_queues+sim->queue.run_queue[place];
+		heap_delete(&expired->deadlines, place);
+		heap_insert(&expired->overdue, place);
+	}
+	/*once few processes are left in the heaps, the small queue is faster*/
+	if (run_queue->in_heap && feasible->size+late->size<=SMALL_QUEUE_SIZE/4){
+		to_small(sim, run_queue);
+	}
+	if (!run_queue->in_heap){
+		position=find_first_min(small->keys, small->ties, small->limits, time, small->size);
+		if (running!=-1 && is_feasible(sim, running, time)){
+			if (position!=-1 && is_before_deadline(sim, small->places[position], running)){
+				return small_remove(small, position);
+			}
+			return running;
 		}
-			
-		//once the process started running for the 1st time, its exec time is recorded
-		if( queue[process_to_run].remainingTime == queue[process_to_run].serviceTime){
-			queue[process_to_run].execTime=time;
+		if (position!=-1){
+			return small_remove(small, position);
 		}
-		
-		/*deduct one second, if remaining time is more than 0*/		
-		if (queue[process_to_run].remainingTime!=0){
-			queue[process_to_run].remainingTime-=1;
+		/*all the waiting processes have passed the deadline, choose based on FCFS*/
+		if (small->size>0 && (running==-1 || is_before_arrival(sim, small->places[0], running))){
+			return small_remove(small, 0);
 		}
-		//increment of the time and quantum
-		time+=1;
-		q+=1;
-		/*once remaining time is 0, process has finished the execution*/
-		if (queue[process_to_run].remainingTime==0){
-			queue[process_to_run].state=EXIT;
-			printf("Time %d: %10s has finished execution\n", time, queue[process_to_run].processname);
-			summarize(queue[process_to_run], time);
-			add_empty(process_to_run); //process is removed from the queue
-			total_processes-=1; //since the process is deleted the total number of processes to be processed is decreased
-			if (strcmp(queue[process_to_run].processname, "-1")){
-				printf("Time %d: %10s is in the running state\n", time, queue[process_to_run].processname );
-			}
-			q=0;//reset quantum to 0, once the process is deleted
+		return running;
+	}
+	/*moving the processes without a timer which passed the deadline out of the way*/
+	while (feasible->size>0 && !is_feasible(sim, feasible->places[0], time)){
+		place=feasible->places[0];
+		heap_delete(feasible, place);
+		cancel_timer(sim, place);
+		heap_insert(late, place);
+	}
+	if (running!=-1 && is_feasible(sim, running, time)){
+		if (feasible->size>0 && is_before_deadline(sim, feasible->places[0], running)){
+			place=feasible->places[0];
+			heap_delete(feasible, place);
+			cancel_timer(sim, place);
+			return place;
 		}
+		return running;
+	}
+	/*a process which can still meet the deadline goes before the overdue ones*/
+	if (feasible->size>0){
+		place=feasible->places[0];
+		heap_delete(feasible, place);
+		cancel_timer(sim, place);
+		return place;
+	}
+	/*If all the remaining processes have passed the deadline, choose based on FCFS*/
+	if (late->size>0 && (running==-1 || is_before_arrival(sim, late->places[0], running))){
+		place=late->places[0];
+		heap_delete(late, place);
+		return place;
 	}
+	return running;
 }
 
 /*
- * Function: find_next
+ * Function: deadline_on_preempt
  * -------------------
- * Finds the process which is most likely to reach its deadline from those in the 
- * queue. If all the processes are over the deadline, works based on FCFS algorithm
+ * puts the process, which was running, back into the run queue of the CPU it belongs to
  *
- * time: time, right at the moment when the process is being searched for
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
  *
- * returns: the process with the shortest remaining time
+ * returns: none
  */
-int find_next(int time){
-	/*Initialization*/
-	int process_to_run=-1;
-	int gap;
-	int min_gap= (int) (long)NULL;
-	int look_up=0;
-	
-	//Looping from the first process till the last inserted to the queue
-	while (look_up<rear){
-		if (strcmp(queue[look_up].processname, "-1" )){
-			/* Find the how many seconds are there before the process passes the deadline*/
-			gap=queue[look_up].deadline-(time-queue[look_up].entryTime);
-			
-			/* Prioritize processes with positive gap, meaning they still did not pass the deadline*/
-			/* Checking whether it is possible for the process to complete executing within the deadline*/
-			if (queue[look_up].remainingTime<=gap && gap>0){
-				//finding the process with the minimal gap 
-				if (min_gap > gap || min_gap == (int) (long) NULL){
-					process_to_run=look_up;
-					min_gap=gap;
-				}
-				//if there are two processes with the same gap
-				else if (min_gap == gap){
-					//checking which process has smaller deadline, since it's most likely to be reached faster
-					if(queue[look_up].deadline<queue[process_to_run].deadline){
-						process_to_run=look_up;
-						min_gap=gap;
-					}
-				}
-			}
-		}
-	look_up+=1;
+static void deadline_on_preempt(simulation_t *sim, int cpu, int place, int time){
+	run_queue_t *run_queue=((deadline_t *)sim->policy_data)->run_queues+cpu;
+	if (!run_queue->in_heap){
+		deadline_on_arrival(sim, cpu, place, time);
 	}
-	
-	/*If all the remaining processes have passed the deadline*/
-	if (process_to_run==-1){
-		/*Choose the remaining processes based on FCFS*/
-		look_up=0;
-		while (look_up<rear){
-			if (strcmp(queue[look_up].processname, "-1" )){
-				process_to_run=look_up;
-				break;
-			}
-			look_up+=1;
-		}
+	else{
+		heap_add(sim, run_queue, place);
 	}
-	return process_to_run; //process to run
 }
 
 /*
- * Function: add_empty_processes
- * -----------------------------
- * loops through each line of the file ( which corresponds to a single process) 
- * and inserts the default empty processes there ( by calling add_empty()).
- * Counts how many processes are supposed to be processed
+ * Function: latest_start
+ * -------------------
+ * Finds the last second, in which the waiting process can still meet the deadline
+ * (see is_feasible()): since it does not run while it waits, it is
+ * absolute deadline - remaining time, but at least 1 second before the absolute deadline.
  *
- * fp: file to be read from
+ * sim: the simulation
+ * place: place of the process in the queue
  *
- * returns: number of processes to be processed
+ * returns: the latest start
  */
-int add_empty_processes(FILE *fp){
-	char c;
-	int count=0;
-	for (c= getc(fp); c!= EOF; c= getc(fp))
-		if (c =='\n'){
-			add_empty(count); //adds an empty process to the queue
-			count+=1; //increased when a single line of a while is read
-		}
-	rewind(fp); //reset the pointer back to the beginning of the file
-	return count;
+static int latest_start(simulation_t *sim, int place){
+	process_table_t *queue=&sim->queue;
+	int remaining=queue->remainingTime[place];
+	return queue->entryTime[place]+queue->deadline[place]-(remaining>1 ? remaining : 1);
+}
+
+/*
+ * Function: small_add
+ * -------------------
+ * adds the process to the small queue, by its absolute deadline (entry time + deadline)
+ * and deadline, with its latest start as the limit (see latest_start()).
+ *
+ * sim: the simulation
+ * small: the small queue
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+static void small_add(simulation_t *sim, small_queue_t *small, int place){
+	process_table_t *queue=&sim->queue;
+	small_insert(sim, small, place, queue->entryTime[place]+queue->deadline[place], queue->deadline[place], latest_start(sim, place));
+}
+
+/*
+ * Function: heap_add
+ * -------------------
+ * adds the process to the heap of the processes, which can still meet the deadline.
+ * A process with at least TIMER_MIN_REMAINING seconds left to run gets a timer, which
+ * expires right after its latest start (see latest_start()), or goes to the overdue
+ * ones right away if the timing wheel got past that time already. The others are
+ * moved out of the way once they reach the top, which is about when they pass their
+ * latest start anyway, so a timer would cost more than it saves.
+ *
+ * sim: the simulation
+ * run_queue: the run queue
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+static void heap_add(simulation_t *sim, run_queue_t *run_queue, int place){
+	if (sim->queue.remainingTime[place]<TIMER_MIN_REMAINING || wheel_add(sim, &((deadline_t *)sim->policy_data)->wheel, place, latest_start(sim, place)+1)){
+		heap_insert(&run_queue->deadlines, place);
+	}
+	else{
+		heap_insert(&run_queue->overdue, place);
+	}
 }
 
 /*
- * Function: summarize
+ * Function: cancel_timer
  * -------------------
- * Calculates process's wait time, turnaround time and determines whether the 
- * deadline was met. 
- * Writes all that information about the process to the file "results-3.txt"
+ * cancels the timer of the process, which leaves the heaps. Only a process with at least
+ * TIMER_MIN_REMAINING seconds left to run may have one, and it does not run while it
+ * waits, so the others are not looked up in the timing wheel.
  *
- * process: process, that summary is about
- * time: time, when the process completed execution
+ * sim: the simulation
+ * place: place of the process in the queue
  *
  * returns: none
  */
-void summarize (pcb_t process, int time){
-	/*Initialization*/
-	int deadline_satisfied=0;
-	int wait_time;
-	int turnaround_time;
-	/*Open the file*/
-	FILE *fpw;
-	fpw = fopen ("results-3.txt", "a");
-	
-	turnaround_time=time-process.entryTime; //calculating the turnaround time
-	wait_time=process.execTime-process.entryTime; //calculating the wait time
-	/*Determining whether the deadline is satisfied*/
-	if (turnaround_time<=process.deadline){
-		deadline_satisfied = 1;
+static void cancel_timer(simulation_t *sim, int place){
+	if (sim->queue.remainingTime[place]>=TIMER_MIN_REMAINING){
+		wheel_cancel(&((deadline_t *)sim->policy_data)->wheel, place);
 	}
-	// Adding the summary to the file
-	fprintf(fpw, "%s %d %d %d\n", process.processname, wait_time, turnaround_time, deadline_satisfied);
-	fclose(fpw);
 }
 
+/*
+ * Function: to_heap
+ * -------------------
+ * moves the processes of the small queue into the heaps (see heap_add())
+ *
+ * sim: the simulation
+ * run_queue: the run queue
+ *
+ * returns: none
+ */
+static void to_heap(simulation_t *sim, run_queue_t *run_queue){
+	while (run_queue->small.size>0){
+		heap_add(sim, run_queue, small_remove(&run_queue->small, run_queue->small.size-1));
+	}
+	run_queue->in_heap=1;
+}
+
+/*
+ * Function: to_small
+ * -------------------
+ * moves the processes of both heaps into the small queue, cancelling their timers
+ *
+ * sim: the simulation
+ * run_queue: the run queue
+ *
+ * returns: none
+ */
+static void to_small(simulation_t *sim, run_queue_t *run_queue){
+	heap_t *heaps[2]={&run_queue->deadlines, &run_queue->overdue};
+	int look_up;
+	int place;
+	for (look_up=0; look_up<2; look_up++){
+		while (heaps[look_up]->size>0){
+			place=heaps[look_up]->places[heaps[look_up]->size-1];
+			heap_delete(heaps[look_up], place);
+			cancel_timer(sim, place);
+			small_add(sim, &run_queue->small, place);
+		}
+	}
+	run_queue->in_heap=0;
+}
@@ -3,333 +3,142 @@
  * Start date: 01/10/2021
  * Last modified: 06/08/2021
  * -------------------------
- * 
- * The following application is a simulation of non-preemptive FCFS scheduling 
- * algorithm. It gets the information about each process from the file, where each
- * line represents a singe process in form of:
- * 		[Process Name] [Arrival Time] [Service Time] [Deadline]. 
- *  It schedules the processes accordingly ( in order of arrival), printing out the main events:
- *		- when the new process enters
- *		- when any of the processes finishes execution
- *		- which process is currently running ( when any of the events above happen)
  *
- * Moreover, it saves information about each of the processes into results-1.txt
- * in form of:
- * 		[Process name] [Wait time] [Turnaround Time] [Deadline Met]
+ * The following is the non-preemptive FCFS scheduling policy for the simulation core
+ * (see scheduler.c). It schedules the processes accordingly ( in order of arrival):
+ * the running process runs till the end of its execution, and then the process which
+ * entered the system first of the waiting ones runs next.
+ *
+ * The results are saved into results-1.txt. The timing of the original FCFS program
+ * is kept (see simulate()).
  */
 
-#include <stdio.h>      /* standard I/O routines */
-#include <stdlib.h>     /* needed for exit function */
-#include <string.h>     /* string operations */
-#define MAX 100
-
-
+#include <stdlib.h>     /* needed for realloc */
+#include <string.h>     /* memcpy */
+#include "scheduler.h"
 
-/*Special enumerated data type for process state*/
-typedef enum {
-	READY, RUNNING, EXIT
-} process_state_t;
-
-/* C data structure used as process control block. The scheduler should create
-one instance per running process in the system*/
+/* Run queue of a CPU: places of the waiting processes in order of arrival, wrapping around*/
 typedef struct{
-	char processname[11]; // A string that identifies the process
-	
-	/*Times are measured in seconds*/
-	int entryTime; // The time process enteres system
-	int serviceTime; //The total CPU time required by the process
-	int remainingTime; //Remaining service time until completion 
-	
-	int deadline; //The expected turnaround time
-	
-	process_state_t state; //current process state(e.g. READY)
-} pcb_t;
-
-/*global variables*/
-int rear= 0; //points at the last inserted process
-int front=0; //points at the process being currently processed
-pcb_t queue[MAX];
+	int *places; //places of the processes in the queue
+	int front; //position of the process which entered first
+	int count; //number of waiting processes
+	int capacity; //number of positions allocated
+} fifo_t;
 
 /*functions*/
-void add_empty(int count);
-void insert();
-void delete();
-void fill_empy_process();
-int new_process(FILE *fp);
-void remaining_processes(int time);
-void add_empty_processes(FILE *fp);
-void summarize (pcb_t process, int time);
-void clear_output_file(); 
+static void fcfs_on_start(simulation_t *sim);
+static void fcfs_on_arrival(simulation_t *sim, int cpu, int place, int time);
+static int fcfs_select_next(simulation_t *sim, int cpu, int time, int running);
+static void fcfs_on_end(simulation_t *sim);
+static void fifo_grow(simulation_t *sim, fifo_t *fifo);
 
+policy_t fcfs_policy={"fcfs", 1, 0, 1, 1, fcfs_on_start, fcfs_on_arrival, fcfs_select_next, NULL, NULL, fcfs_on_end, NULL, NULL, NULL};
 
 
 /*
- * Function: main 
- * --------------
- * opens the file for reading from it, checking whether the user input is valid. 
- * if the user did not specify the file to read from, opens the default "processes.txt",
- * otherwise opens the specified file. 
- *
- * calls the clear_output_file() function to clear the "results-1.txt" file
- *
- * calls the add_empty_processes() function to initialize all the processes with default numbers
+ * Function: fcfs_on_start
+ * -------------------
+ * creates an empty run queue for every CPU of the simulation
  *
- * calls the scheduling functions to schedule the processes with FCFS approach
+ * sim: the simulation
  *
- * argc: argument counter, which is the number of arguments the user input
- * argv: array containing all the arguments the user input 
- * 
  * returns: none
  */
-int main(int argc, char* argv[])
-{
-	/*open files*/
-	FILE *fp;
-	if (argc>1){
-		fp = fopen (argv[1], "r");
-	}
-	else{
-		fp = fopen ("processes.txt", "r");
+static void fcfs_on_start(simulation_t *sim){
+	sim->policy_data=calloc(sim->cpus, sizeof(fifo_t));
+	if (sim->policy_data==NULL){
+		out_of_memory(sim);
 	}
-	
-	/*handling the non-existent file*/
-	if (fp==NULL){
-		printf("The file could not be open. Try again");
-		exit(0); 
-	}
-	/*clear the output file*/
-	clear_output_file();
-	
-	/*initialize time*/
-	int time=0;
-	
-	/*counting number of lines in the file and adding and empty processes to the queue
-	for each line*/
-	add_empty_processes(fp);
-	
-	/*adding processes and working on them*/
-	time=new_process(fp);
-	
-	time-=1; //needed since after the last process is added, time is increased 
-	
-	/*after all the processes are added, work on the processes which remain in the system*/
-	remaining_processes(time);
-	
-	/*closing the open file*/
-	fclose(fp);
-	
-	exit(0); 
 }
 
-
 /*
- * Function: clear_output_file
+ * Function: fcfs_on_end
  * -------------------
- * clears the content of the "results-1.txt" file
+ * frees the run queues of the simulation
  *
- * returns: none
- */
-void clear_output_file(){
-	fclose(fopen("results-1.txt", "w"));
-}
-
-
-/*
- * Function: insert
- * -------------------
- * inserts the process into the queue, checking whether total number does not excess the
- * limitation. Places the rear pointer at the last inserted process.
- * 
- * process: the instance of pcb_t struct, which is to be inserted
+ * sim: the simulation
  *
  * returns: none
  */
-void insert(pcb_t process){
-	if (rear == MAX ){
-		printf("The number of processes is exceeding the limit");
-		exit(0); 
+static void fcfs_on_end(simulation_t *sim){
+	fifo_t *waiting=sim->policy_data;
+	int look_up;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		free(waiting[look_up].places);
 	}
-	else{
-		//if the queue has no processes
-		if (front == -1){
-			front = 0;
-		}
-		queue[rear]= process;
-		rear=rear+1;
-	}
-}
-
-/*
- * Function: delete
- * -------------------
- * deletes the front process from the queue by calling add_empty() function
- * and resetting front pointer to the next process
- *
- * returns: none
- */
-void delete(){
-	add_empty(front);
-	front+=1;
+	free(waiting);
+	sim->policy_data=NULL;
 }
 
-
 /*
- * Function: add_empty
+ * Function: fcfs_on_arrival
  * -------------------
- * adds the process with all the default attributes to the given position
+ * adds the process to the end of the run queue of the CPU
  *
- * count: position of the process to be deleted
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
  *
  * returns: none
  */
-void add_empty(int count){
-	pcb_t process; 
-	strcpy(process.processname, "-1");
-	process.entryTime= -1;
-	process.serviceTime =-1;
-	process.remainingTime=-1;
-	queue[count]= process;
+static void fcfs_on_arrival(simulation_t *sim, int cpu, int place, int time){
+	fifo_t *fifo=(fifo_t *)sim->policy_data+cpu;
+	if (fifo->count==fifo->capacity){
+		fifo_grow(sim, fifo);
+	}
+	fifo->places[(fifo->front+fifo->count)%fifo->capacity]=place;
+	fifo->count+=1;
 }
 
 /*
- * Function: new_process
+ * Function: fcfs_select_next
  * -------------------
- * works on scheduling the processes, when there are processes that are NOT read from the
- * file. reads the file line by line, inserting the processes to the queue at their 
- * entry time, while allowing other process to run
+ * keeps the running process running till the end of its execution. Once no process
+ * is running, takes the process which entered first from the run queue of the CPU.
  *
- * fp: file to be read from
+ * sim: the simulation
+ * cpu: index of the CPU
+ * time: time, right at the moment when the process is being searched for
+ * running: process that is in a state of running (-1 if none)
  *
- * returns: none
+ * returns: the process to run, -1 if there are no processes
  */
-int new_process(FILE *fp){
-	/* initialization*/
-	pcb_t process;
-	size_t len = 128; //maximum length of line is 128 char
-	char *line= malloc(sizeof(char)*len); //allocating space
-	int time=0; //current time in seconds
-	int inserted; // shows whether the character was inserted or not
-	
-	while (fgets(line, len, fp)!=NULL){ //while there is a line in the file to be read
-		/*reading new line into process*/
-		sscanf (line, "%10s%d%d%d", process.processname, &process.entryTime, &process.serviceTime, &process.deadline);
-		process.remainingTime=process.serviceTime;
-		
-		inserted=0; //reinitializing to 0 for every new line
-		
-		while (inserted == 0){
-			/*insert the process once the time reaches it's enrty time*/
-			if (process.entryTime <= time){
-				insert(process); 
-				queue[rear].state=READY; // process is in a ready state once inserted
-				printf("Time %d: %10s has entered the system\n", process.entryTime, process.processname );
-				inserted = 1; //shows that it was inserted
-				if (!strcmp(process.processname,queue[front].processname ))
-					printf("Time %d: %10s is in the running state\n", time, queue[front].processname );
-			}
-			
-			/*ensuring the process exists*/
-			if (strcmp (queue[front].processname , "-1" )){
-				queue[front].state=RUNNING;
-				/*deduct one second, if remaining time is more than 0*/
-				if (queue[front].remainingTime!=0){
-					queue[front].remainingTime-=1;
-				}
-				/*once remaining time is 0, process has finished the execution*/
-				else if (queue[front].remainingTime==0){
-					queue[front].state=EXIT;
-					printf("Time %d: %10s has finished execution\n", time, queue[front].processname);
-					summarize(queue[front], time);
-					delete(); //process is removed from the queue
-					printf("Time %d: %10s is in the running state\n", time, queue[front].processname );
-				}	
-			}
-			time+=1; //incrementing every second
-		}
+static int fcfs_select_next(simulation_t *sim, int cpu, int time, int running){
+	fifo_t *fifo=(fifo_t *)sim->policy_data+cpu;
+	int place;
+	if (running!=-1){
+		return running;
 	}
-	free(line); //empty allocated space
-	return time;
-}
-
-
-/*
- * Function: remaining_processes
- * ------------------------------
- * works on scheduling the processes, when ALL the processes are read from the
- * file. works on the remaining processes, scheduling them according to FCFS algorithm
- *
- * time: time which the new_process() stopped running at
- *
- * returns: none
- */
-void remaining_processes(int time){
-	
-	/*works on the remaining processes*/
-	while(front<rear){ 
-		/*once remaining time is 0, process has finished the execution*/
-		if (queue[front].remainingTime==0){
-			queue[front].state=EXIT; //resetting it's state to exit
-			printf("Time %d: %10s has finished execution\n", time, queue[front].processname);
-			summarize(queue[front], time);
-			delete(); //process is removed from the queue
-			if (front<rear)
-				printf("Time %d: %10s is in the running state\n", time, queue[front].processname );
-		}
-		queue[front].state=RUNNING;
-		queue[front].remainingTime-=1; //decrement remaining time every iteration
-		time+=1; //incrementing every second
+	if (fifo->count==0){
+		return -1;
 	}
+	place=fifo->places[fifo->front];
+	fifo->front=(fifo->front+1)%fifo->capacity;
+	fifo->count-=1;
+	return place;
 }
 
 /*
- * Function: add_empty_processes
- * -----------------------------
- * loops through each line of the file ( which corresponds to a single process) 
- * and inserts the default empty processes there ( by calling add_empty()).
- *
- * fp: file to be read from
- *
- * returns: none
- */
-void add_empty_processes(FILE *fp){
-	char c; 
-	int count=0;
-	for (c= getc(fp); c!= EOF; c= getc(fp))
-		if (c =='\n')
-			add_empty(count); //adds an empty process to the queue
-			count+=1; //increased when a single line of a while is read
-	rewind(fp); //reset the pointer back to the beginning of the file
-}
-
-/*
- * Function: summarize
+ * Function: fifo_grow
  * -------------------
- * Calculates process's wait time, turnaround time and determines whether the 
- * deadline was met. 
- * Writes all that information about the process to the file "results-1.txt"
+ * doubles the number of positions allocated for the run queue. The waiting processes,
+ * which wrapped around to the beginning, are moved after the old end, so that they
+ * keep following the others.
  *
- *
- * process: process, that summary is about
- * time: time, when the process completed execution
+ * sim: the simulation
+ * fifo: run queue to be changed
  *
  * returns: none
  */
-void summarize (pcb_t process, int time){
-	/*Initialization*/
-	int deadline_satisfied=0;
-	int wait_time;
-	int turnaround_time;
-	/*Open the file*/
-	FILE *fpw;
-	fpw = fopen ("results-1.txt", "a");
-	
-	turnaround_time=time-process.entryTime; //calculating the turnaround time
-	wait_time=turnaround_time-process.serviceTime; //calculating the wait time
-	/*Determining whether the deadline is satisfied*/
-	if (turnaround_time<=process.deadline){
-		deadline_satisfied = 1;
+static void fifo_grow(simulation_t *sim, fifo_t *fifo){
+	int new_capacity=fifo->capacity==0 ? INITIAL_CAPACITY : fifo->capacity*2;
+	fifo->places=realloc(fifo->places, sizeof(int)*new_capacity);
+	if (fifo->places==NULL){
+		out_of_memory(sim);
+	}
+	if (fifo->front+fifo->count>fifo->capacity){
+		memcpy(fifo->places+fifo->capacity, fifo->places, sizeof(int)*(fifo->front+fifo->count-fifo->capacity));
 	}
-	// Adding the summary to the file
-	fprintf(fpw, "%s %d %d %d\n", process.processname, wait_time, turnaround_time, deadline_satisfied);
-	fclose(fpw);
+	fifo->capacity=new_capacity;
 }
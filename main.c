@@ -0,0 +1,426 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * The following application is a simulation of the process scheduling. It runs the
+ * processes in the file with the scheduling algorithm chosen by the user:
+ *		- fcfs: non-preemptive FCFS (results-1.txt)
+ *		- srtn: preemptive SRTN(q=3) (results-2.txt)
+ *		- deadline: preemptive deadline-driven(q=1) (results-3.txt)
+ *		- mlfq: preemptive multi-level feedback queue (results-4.txt)
+ *		- stride: preemptive stride scheduling, by the tickets of the processes (results-5.txt)
+ * or, in the sweep mode, runs them with every combination of the given algorithms,
+ * quantums and numbers of CPUs, and prints out a table comparing them (see sweep.c),
+ * or, in the service mode, simulates the processes sent by clients (see service.c).
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* string operations */
+#include <unistd.h>     /* getopt */
+#include "scheduler.h"
+#define MAX_VALUES 64 //maximum number of values of an option in the sweep mode
+
+/*global variables*/
+policy_t *policies[]={&fcfs_policy, &srtn_policy, &deadline_policy, &mlfq_policy, &stride_policy}; //policies to choose from
+int policy_count= sizeof(policies)/sizeof(policies[0]); //number of policies to choose from
+
+/*functions*/
+int parse_policies(char *text, policy_t **chosen);
+int parse_numbers(char *text, int *numbers);
+void usage(char *program);
+
+
+
+/*
+ * Function: main
+ * --------------
+ * opens the file for reading from it, checking whether the user input is valid.
+ * if the user did not specify the file to read from, opens the default "processes.txt",
+ * otherwise opens the specified file. If the file is "-", the processes are read from
+ * the standard input. A binary trace file (see trace.c) is recognized and mapped into
+ * memory instead of being read. With -w, the processes are written into a binary trace
+ * file instead of being simulated. With -U, the file does not have to be in order of the
+ * entry times: its processes are sorted by them first (see sort.c), in at most -M
+ * megabytes of memory, and are then taken from the sorted trace.
+ *
+ * calls the open_results() function to open the results file, with the format (-f)
+ * and the size of its buffer (-b) given by the user. -l sets which events are printed out.
+ * -r sets whether a line per process is written to the results file, a summary of all
+ * of them is printed out after the events, or both
+ *
+ * simulates the scheduling of the processes with the policy given by the user (-p),
+ * FCFS by default, with the quantum given by the user (-q), the default one of the
+ * policy otherwise, on the number of CPUs given by the user (-c), 1 by default. -s and -m
+ * give the seconds a context switch and a migration cost the CPU, none by default.
+ * For MLFQ, -Q gives the comma separated quantums of the levels, from the top one (they
+ * take the place of -q, which MLFQ ignores), and -B the seconds after which all the
+ * processes go back to the top level (0 for never).
+ * -F adds the share deviation of every process, how far the CPU time it got is from its
+ * share by the tickets, to the results file and the summary.
+ *
+ * with -S, -p, -q and -c take comma separated lists, and every combination of them
+ * is simulated, -j at the same time
+ *
+ * with -P, the processes are read in advance and a single CPU with FCFS or SRTN is
+ * simulated a shard of them at a time, -j shards at the same time (see shard.c)
+ *
+ * with -k, the state of the simulation is saved into the checkpoint file every -K seconds
+ * (see checkpoint.c), and the file is removed once the simulation is over. -R resumes the
+ * simulation from the checkpoint file, given the same options and file as before.
+ *
+ * with -u, the program runs as a service instead: the processes are sent by clients
+ * through the Unix domain socket at the given path, and the events are sent back to them
+ * (see service.c). It runs until it is stopped.
+ *
+ * argc: argument counter, which is the number of arguments the user input
+ * argv: array containing all the arguments the user input
+ *
+ * returns: none
+ */
+int main(int argc, char* argv[])
+{
+	int option;
+	long buffer_size=RESULTS_BUFFER_SIZE;
+	int sweep_mode=0; //1 if every combination of the options is to be simulated
+	int jobs=sysconf(_SC_NPROCESSORS_ONLN); //number of simulations running at the same time
+	policy_t *chosen[MAX_VALUES]={&fcfs_policy}; //policies given by the user
+	int chosen_count=1;
+	int quanta[MAX_VALUES]; //quantums given by the user
+	int quantum_count=0; //0 if the default quantums of the policies are used
+	int cpu_counts[MAX_VALUES]={1}; //numbers of CPUs given by the user
+	int cpu_count=1;
+	format_t format=TEXT;
+	log_level_t log_level=LOG_FULL;
+	results_t results=RESULTS_LINES;
+	simulation_t sim;
+	trace_t trace;
+	int mapped=0; //1 if the file is a binary trace
+	char *binary_trace=NULL; //binary trace file the processes are written into
+	char *filename="processes.txt";
+	char *checkpoint=NULL; //file the state of the simulation is saved to
+	int checkpoint_interval=CHECKPOINT_INTERVAL; //seconds between two checkpoints
+	int resume=0; //1 if the simulation goes on from the checkpoint
+	int switch_cost=0; //seconds a CPU spends on a context switch
+	int migration_cost=0; //seconds it spends on top of that on a migration
+	int level_quanta[MAX_VALUES]; //quantums of the levels given by the user (MLFQ)
+	int levels=0; //0 if the default levels are used
+	int boost_period=BOOST_PERIOD; //seconds after which all the processes go back to the top level
+	int fair_share=0; //1 if the share deviation of the processes is reported
+	char *service=NULL; //socket the clients send the processes to, in the service mode
+	int unsorted=0; //1 if the processes of the file are to be sorted by entry time
+	long sort_memory=SORT_MEMORY; //number of bytes they are sorted in
+	int parallel=0; //1 if the shards of the processes are simulated at the same time
+	int look_up;
+
+	/*reading the options*/
+	while ((option=getopt(argc, argv, "p:q:c:f:b:l:r:Sj:w:k:K:Rs:m:Q:B:Fu:UM:P"))!=-1){
+		if (option=='p'){
+			chosen_count=parse_policies(optarg, chosen);
+		}
+		else if (option=='q'){
+			quantum_count=parse_numbers(optarg, quanta);
+		}
+		else if (option=='c'){
+			cpu_count=parse_numbers(optarg, cpu_counts);
+		}
+		else if (option=='f' && !strcmp(optarg, "text")){
+			format=TEXT;
+		}
+		else if (option=='f' && !strcmp(optarg, "csv")){
+			format=CSV;
+		}
+		else if (option=='f' && !strcmp(optarg, "binary")){
+			format=BINARY;
+		}
+		else if (option=='b' && atol(optarg)>0){
+			buffer_size=atol(optarg);
+		}
+		else if (option=='l' && !strcmp(optarg, "off")){
+			log_level=LOG_OFF;
+		}
+		else if (option=='l' && !strcmp(optarg, "summary")){
+			log_level=LOG_SUMMARY;
+		}
+		else if (option=='l' && !strcmp(optarg, "full")){
+			log_level=LOG_FULL;
+		}
+		else if (option=='r' && !strcmp(optarg, "lines")){
+			results=RESULTS_LINES;
+		}
+		else if (option=='r' && !strcmp(optarg, "summary")){
+			results=RESULTS_SUMMARY;
+		}
+		else if (option=='r' && !strcmp(optarg, "both")){
+			results=RESULTS_BOTH;
+		}
+		else if (option=='S'){
+			sweep_mode=1;
+		}
+		else if (option=='j' && atoi(optarg)>0){
+			jobs=atoi(optarg);
+		}
+		else if (option=='w'){
+			binary_trace=optarg;
+		}
+		else if (option=='k'){
+			checkpoint=optarg;
+		}
+		else if (option=='K' && atoi(optarg)>=0){
+			checkpoint_interval=atoi(optarg);
+		}
+		else if (option=='R'){
+			resume=1;
+		}
+		else if (option=='s' && atoi(optarg)>=0){
+			switch_cost=atoi(optarg);
+		}
+		else if (option=='m' && atoi(optarg)>=0){
+			migration_cost=atoi(optarg);
+		}
+		else if (option=='Q'){
+			levels=parse_numbers(optarg, level_quanta);
+			if (levels<=0 || levels>MAX_LEVELS){
+				usage(argv[0]);
+			}
+		}
+		else if (option=='B' && atoi(optarg)>=0){
+			boost_period=atoi(optarg);
+		}
+		else if (option=='F'){
+			fair_share=1;
+		}
+		else if (option=='u'){
+			service=optarg;
+		}
+		else if (option=='U'){
+			unsorted=1;
+		}
+		else if (option=='M' && atol(optarg)>0){
+			sort_memory=atol(optarg)*1024*1024;
+		}
+		else if (option=='P'){
+			parallel=1;
+		}
+		else{
+			usage(argv[0]);
+		}
+		if (chosen_count<=0 || quantum_count<0 || cpu_count<=0){
+			usage(argv[0]);
+		}
+	}
+	/*lists are only taken in the sweep mode*/
+	if (!sweep_mode && (chosen_count>1 || quantum_count>1 || cpu_count>1)){
+		usage(argv[0]);
+	}
+	/*a checkpoint is only kept of a single simulation, simulated in one piece*/
+	if ((resume && checkpoint==NULL) || (checkpoint!=NULL && (sweep_mode || binary_trace!=NULL || parallel))){
+		usage(argv[0]);
+	}
+	/*the service mode has neither a file nor a checkpoint*/
+	if (service!=NULL && (sweep_mode || binary_trace!=NULL || checkpoint!=NULL || unsorted || parallel)){
+		usage(argv[0]);
+	}
+	if (jobs<1){
+		jobs=1;
+	}
+
+	/*the costs and the levels are the same for all the simulations of the sweep and of the service*/
+	init_simulation(&sim, chosen[0], cpu_counts[0]);
+	sim.switch_cost=switch_cost;
+	sim.migration_cost=migration_cost;
+	if (levels>0){
+		sim.levels=levels;
+		for (look_up=0; look_up<levels; look_up++){
+			sim.level_quanta[look_up]=level_quanta[look_up];
+		}
+	}
+	sim.boost_period=boost_period;
+	sim.fair_share=fair_share;
+	/*the quantum does not apply to the policies which are not preemptive, nor to MLFQ, whose levels have quantums of their own*/
+	if (quantum_count>0 && !chosen[0]->fixed_quantum){
+		sim.quantum=quanta[0];
+	}
+	sim.format=format;
+	sim.log_level=log_level;
+
+	/*in the service mode, the processes come from the clients instead of a file*/
+	if (service!=NULL){
+		serve(service, &sim);
+	}
+
+	/*open files*/
+	FILE *fp=NULL;
+	if (optind<argc){
+		filename=argv[optind];
+	}
+	if (!strcmp(filename, "-")){
+		fp = stdin; //the processes may be piped into the program
+	}
+	else if (!(mapped=map_trace(filename, &trace))){
+		fp = fopen (filename, "r");
+	}
+
+	/*handling the non-existent file*/
+	if (fp==NULL && !mapped){
+		printf("The file could not be open. Try again");
+		exit(0);
+	}
+
+	/*the sorted processes are taken from the trace, as if the file was a binary trace*/
+	if (unsorted){
+		sort_trace(mapped ? NULL : fp, &trace, sort_memory);
+		if (!mapped){
+			fclose(fp);
+		}
+		mapped=1;
+	}
+
+	/*the processes are read once and shared by all the simulations of the sweep*/
+	if (sweep_mode || binary_trace!=NULL){
+		if (!mapped){
+			read_trace(fp, &trace);
+			fclose(fp);
+		}
+		if (binary_trace!=NULL){
+			write_trace(&trace, binary_trace);
+		}
+		else{
+			sweep(&trace, chosen, chosen_count, quanta, quantum_count, cpu_counts, cpu_count, jobs, &sim);
+		}
+		free_trace(&trace);
+		exit(0);
+	}
+
+	/*the shards are found in the processes read in advance*/
+	if (parallel && !mapped){
+		read_trace(fp, &trace);
+		fclose(fp);
+		mapped=1;
+	}
+	if (mapped){
+		sim.trace=&trace;
+	}
+	else{
+		sim.reader=open_reader(fp);
+	}
+	sim.checkpoint=checkpoint;
+	sim.checkpoint_interval=checkpoint_interval;
+	if (resume){
+		read_checkpoint(&sim, checkpoint);
+	}
+
+	/*open the output file, unless only the summary is asked for*/
+	if (results!=RESULTS_SUMMARY){
+		open_results(&sim, buffer_size);
+	}
+
+	/*adding processes and working on them*/
+	if (parallel){
+		simulate_shards(&sim, jobs);
+	}
+	else{
+		simulate(&sim);
+	}
+
+	/*closing the open file*/
+	if (mapped){
+		free_trace(&trace);
+	}
+	else{
+		free(sim.reader);
+		fclose(fp);
+	}
+	/*writing out what is left in the buffers*/
+	if (results!=RESULTS_SUMMARY){
+		close_results(&sim);
+	}
+	flush_log(&sim);
+	if (results!=RESULTS_LINES){
+		print_summary(&sim);
+	}
+	/*the simulation is over, so there is nothing to go on from*/
+	if (checkpoint!=NULL){
+		remove(checkpoint);
+	}
+	free_simulation(&sim);
+	exit(0);
+}
+
+/*
+ * Function: parse_policies
+ * -------------------
+ * finds the policies named in the comma separated list
+ *
+ * text: the list
+ * chosen: array the policies are put into
+ *
+ * returns: number of the policies, 0 if any of the names is not known
+ */
+int parse_policies(char *text, policy_t **chosen){
+	char *name=strtok(text, ",");
+	int count=0;
+	int look_up;
+	while (name!=NULL){
+		if (count==MAX_VALUES){
+			return 0;
+		}
+		chosen[count]=NULL;
+		for (look_up=0; look_up<policy_count; look_up++){
+			if (!strcmp(name, policies[look_up]->name)){
+				chosen[count]=policies[look_up];
+			}
+		}
+		if (chosen[count]==NULL){
+			return 0;
+		}
+		count+=1;
+		name=strtok(NULL, ",");
+	}
+	return count;
+}
+
+/*
+ * Function: parse_numbers
+ * -------------------
+ * reads the positive numbers in the comma separated list
+ *
+ * text: the list
+ * numbers: array the numbers are put into
+ *
+ * returns: number of the numbers, -1 if any of them is not positive
+ */
+int parse_numbers(char *text, int *numbers){
+	char *number=strtok(text, ",");
+	int count=0;
+	while (number!=NULL){
+		if (count==MAX_VALUES || atoi(number)<=0){
+			return -1;
+		}
+		numbers[count]=atoi(number);
+		count+=1;
+		number=strtok(NULL, ",");
+	}
+	if (count==0){
+		return -1;
+	}
+	return count;
+}
+
+/*
+ * Function: usage
+ * -------------------
+ * prints out how the program is to be run and stops it
+ *
+ * program: name of the program
+ *
+ * returns: none
+ */
+void usage(char *program){
+	printf("Usage: %s [-p fcfs|srtn|deadline|mlfq|stride] [-q quantum] [-c cpus] [-f text|csv|binary] [-b results buffer size] [-l off|summary|full] [-r lines|summary|both] [-s switch cost] [-m migration cost] [-Q quantum,...] [-B boost period] [-F] [-U [-M megabytes]] [-P [-j threads]] [-k checkpoint file [-K seconds] [-R]] [file]\n", program);
+	printf("       %s -w binary trace file [-U [-M megabytes]] [file]\n", program);
+	printf("       %s -u socket [-p policy] [-q quantum] [-c cpus] [-l off|summary|full] [-s switch cost] [-m migration cost] [-Q quantum,...] [-B boost period] [-F]\n", program);
+	printf("       %s -S [-p policy,...] [-q quantum,...] [-c cpus,...] [-j threads] [-s switch cost] [-m migration cost] [-Q quantum,...] [-B boost period] [-U [-M megabytes]] [file]\n", program);
+	printf("fcfs and mlfq ignore -q: fcfs is not preemptive, and the levels of mlfq have their quantums (-Q)\n");
+	exit(0);
+}
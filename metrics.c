@@ -0,0 +1,217 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Aggregate metrics of a simulation, kept while the processes finish, so that the
+ * averages and quantiles do not need the results file. The wait and turnaround times
+ * go into quantile sketches (sketch_t): histograms whose buckets get wider as the values
+ * get bigger, so that they take the same memory for any number of processes and give
+ * any quantile within 1/128 of its value. Two sketches are merged by adding up their
+ * buckets, so the sketches of separate simulations can be put together.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include "scheduler.h"
+
+/*functions*/
+static int bucket_of(int value);
+static int value_of(int bucket);
+
+
+/*
+ * Function: bucket_of
+ * -------------------
+ * finds the bucket of the value: values below 2*SKETCH_PRECISION have a bucket each,
+ * bigger ones share a bucket with the values which have the same highest bits
+ * (SKETCH_PRECISION buckets for every power of 2)
+ *
+ * value: the value, negative ones are counted as 0
+ *
+ * returns: index of the bucket
+ */
+static int bucket_of(int value){
+	int shift;
+	if (value<2*SKETCH_PRECISION){
+		return value<0 ? 0 : value;
+	}
+	shift=31-__builtin_clz(value)-SKETCH_BITS; //bits cut off the value
+	return 2*SKETCH_PRECISION+(shift-1)*SKETCH_PRECISION+((value>>shift)-SKETCH_PRECISION);
+}
+
+/*
+ * Function: value_of
+ * -------------------
+ * finds the value in the middle of the bucket, which stands for all the values in it
+ *
+ * bucket: index of the bucket
+ *
+ * returns: the value
+ */
+static int value_of(int bucket){
+	int shift;
+	int lowest;
+	if (bucket<2*SKETCH_PRECISION){
+		return bucket;
+	}
+	shift=(bucket-2*SKETCH_PRECISION)/SKETCH_PRECISION+1;
+	lowest=((bucket-2*SKETCH_PRECISION)%SKETCH_PRECISION+SKETCH_PRECISION)<<shift;
+	return lowest+((1<<shift)-1)/2;
+}
+
+/*
+ * Function: sketch_add
+ * -------------------
+ * adds the value to the sketch
+ *
+ * sketch: the sketch
+ * value: the value
+ *
+ * returns: none
+ */
+void sketch_add(sketch_t *sketch, int value){
+	if (sketch->count==0 || value<sketch->min){
+		sketch->min=value;
+	}
+	if (sketch->count==0 || value>sketch->max){
+		sketch->max=value;
+	}
+	sketch->buckets[bucket_of(value)]+=1;
+	sketch->count+=1;
+	sketch->sum+=value;
+}
+
+/*
+ * Function: sketch_merge
+ * -------------------
+ * adds all the values of one sketch to another one
+ *
+ * sketch: sketch to be added to
+ * other: sketch whose values are added
+ *
+ * returns: none
+ */
+void sketch_merge(sketch_t *sketch, sketch_t *other){
+	int look_up;
+	if (other->count==0){
+		return;
+	}
+	if (sketch->count==0 || other->min<sketch->min){
+		sketch->min=other->min;
+	}
+	if (sketch->count==0 || other->max>sketch->max){
+		sketch->max=other->max;
+	}
+	for (look_up=0; look_up<SKETCH_BUCKETS; look_up++){
+		sketch->buckets[look_up]+=other->buckets[look_up];
+	}
+	sketch->count+=other->count;
+	sketch->sum+=other->sum;
+}
+
+/*
+ * Function: sketch_quantile
+ * -------------------
+ * finds the value, which the given share of the values is not above
+ *
+ * sketch: the sketch
+ * share: the share, from 0 to 1 (0.5 for the median)
+ *
+ * returns: the value, within 1/128 of the exact one, 0 if the sketch is empty
+ */
+int sketch_quantile(sketch_t *sketch, double share){
+	long rank=(long)(share*sketch->count); //number of values below the one searched for
+	long seen=0;
+	int look_up;
+	int value;
+	if (sketch->count==0){
+		return 0;
+	}
+	/*the value is the one at the share of the values, rounded up*/
+	if (rank==share*sketch->count){
+		rank-=1;
+	}
+	if (rank<0){
+		rank=0;
+	}
+	if (rank>=sketch->count){
+		rank=sketch->count-1;
+	}
+	for (look_up=0; look_up<SKETCH_BUCKETS; look_up++){
+		seen+=sketch->buckets[look_up];
+		if (seen>rank){
+			break;
+		}
+	}
+	/*the exact smallest and biggest values are known*/
+	value=value_of(look_up);
+	if (value<sketch->min){
+		return sketch->min;
+	}
+	if (value>sketch->max){
+		return sketch->max;
+	}
+	return value;
+}
+
+/*
+ * Function: sketch_mean
+ * -------------------
+ * finds the exact mean of the values in the sketch
+ *
+ * sketch: the sketch
+ *
+ * returns: the mean, 0 if the sketch is empty
+ */
+double sketch_mean(sketch_t *sketch){
+	if (sketch->count==0){
+		return 0;
+	}
+	return (double)sketch->sum/sketch->count;
+}
+
+/*
+ * Function: print_summary
+ * -------------------
+ * prints out the summary of the simulation, after the events:
+ * the mean, median, 95th and 99th percentile of the wait and turnaround times,
+ * the share of the processes which missed the deadline, the utilization of the CPUs,
+ * the number of context switches (a CPU starting to run another process), the time
+ * the CPUs lost on them if they cost anything, the mean and the biggest share deviation
+ * (as absolute values) if it is asked for, and the time when the last process finished
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+void print_summary(simulation_t *sim){
+	sketch_t *sketches[2]={&sim->wait_times, &sim->turnaround_times};
+	char *names[2]={"wait time", "turnaround time"};
+	long busy_time=0;
+	long switches=0;
+	long lost_time=0;
+	int look_up;
+
+	flush_log(sim);
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		busy_time+=sim->cpu[look_up].busy_time;
+		switches+=sim->cpu[look_up].switches;
+		lost_time+=sim->cpu[look_up].lost_time;
+	}
+	printf("Summary of %ld processes:\n", sim->finished);
+	for (look_up=0; look_up<2; look_up++){
+		printf("\t%s: mean %.2f, p50 %d, p95 %d, p99 %d, max %d\n", names[look_up], sketch_mean(sketches[look_up]),
+			sketch_quantile(sketches[look_up], 0.5), sketch_quantile(sketches[look_up], 0.95),
+			sketch_quantile(sketches[look_up], 0.99), sketches[look_up]->max);
+	}
+	printf("\tdeadline miss rate: %.4f\n", sim->finished>0 ? 1-(double)sim->deadlines_met/sim->finished : 0);
+	printf("\tCPU utilization: %.4f\n", sim->end_time>0 ? (double)busy_time/((double)sim->end_time*sim->cpus) : 0);
+	printf("\tcontext switches: %ld\n", switches);
+	if (sim->switch_cost>0 || sim->migration_cost>0){
+		printf("\ttime lost on context switches: %ld (%.4f of the CPU time)\n", lost_time,
+			sim->end_time>0 ? (double)lost_time/((double)sim->end_time*sim->cpus) : 0);
+	}
+	if (sim->fair_share){
+		printf("\tshare deviation: mean %.4f, max %.4f\n", sim->finished>0 ? sim->total_deviation/sim->finished : 0, sim->max_deviation);
+	}
+	printf("\tend time: %d\n", sim->end_time);
+}
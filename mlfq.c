@@ -0,0 +1,444 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * The following is the preemptive multi-level feedback queue (MLFQ) scheduling policy for
+ * the simulation core (see scheduler.c). Unlike SRTN, it does not need to know the service
+ * times in advance: it learns which processes are short from how long they have run.
+ * It schedules the processes accordingly:
+ *		- a process of a higher level runs before the processes of the lower ones and
+ *		  preempts them as soon as it enters or is boosted
+ *		- the processes of the same level take turns (round robin)
+ *		- a new process enters at the top level
+ *		- once a process has run for the quantum of its level (however many times it
+ *		  was preempted meanwhile), it moves one level down
+ *		- every boost period, all the processes move back to the top level
+ * The number of levels, their quantums and the boost period are those of the simulation.
+ *
+ * Each level of a run queue is a list of processes linked through their places, so
+ * entering, leaving and moving a whole level take the same time for any number of
+ * processes. A boost moves the lists at once; the levels of the processes are only set
+ * back to the top one once they are looked at.
+ *
+ * The results are saved into results-4.txt.
+ */
+
+#include <stdlib.h>     /* calloc, realloc */
+#include <limits.h>     /* INT_MAX */
+#include "scheduler.h"
+
+/* Run queue of a CPU: a list of waiting processes for every level*/
+typedef struct{
+	int heads[MAX_LEVELS]; //first process of every level, -1 if the level is empty
+	int tails[MAX_LEVELS]; //last process of every level
+} run_queue_t;
+
+/* Run queues of the CPUs and the levels of the processes, kept by place*/
+typedef struct{
+	run_queue_t *run_queues; //run queues of the CPUs
+	int *links; //next process in the same list, -1 for the last one
+	int *levels; //level of the process, 0 being the top one
+	int *left; //seconds the process may still run at its level
+	int *counted; //remaining time of the process when its running time was last counted
+	int *boosts; //number of boosts when the level of the process was set
+	int capacity; //number of places allocated for
+	int boost; //number of boosts so far
+	int last_boost; //time of the last boost
+	int next_boost; //time of the next boost, INT_MAX if never
+} mlfq_t;
+
+/*functions*/
+static void mlfq_on_start(simulation_t *sim);
+static void mlfq_on_arrival(simulation_t *sim, int cpu, int place, int time);
+static int mlfq_select_next(simulation_t *sim, int cpu, int time, int running);
+static void mlfq_on_preempt(simulation_t *sim, int cpu, int place, int time);
+static void mlfq_on_end(simulation_t *sim);
+static int mlfq_decide_at(simulation_t *sim, int cpu, int running, int time);
+static void mlfq_save(simulation_t *sim, FILE *fp);
+static void mlfq_load(simulation_t *sim, FILE *fp);
+static void grow_places(simulation_t *sim, mlfq_t *mlfq);
+static void refresh(simulation_t *sim, mlfq_t *mlfq, int place, int time);
+static void boost(simulation_t *sim, mlfq_t *mlfq, int time);
+static void push(mlfq_t *mlfq, run_queue_t *run_queue, int level, int place);
+
+policy_t mlfq_policy={"mlfq", 4, 1, 1, 0, mlfq_on_start, mlfq_on_arrival, mlfq_select_next, mlfq_on_preempt, NULL, mlfq_on_end, mlfq_decide_at, mlfq_save, mlfq_load};
+
+
+/*
+ * Function: mlfq_on_start
+ * -------------------
+ * creates an empty run queue for every CPU of the simulation
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+static void mlfq_on_start(simulation_t *sim){
+	mlfq_t *mlfq=calloc(1, sizeof(mlfq_t));
+	int look_up;
+	int level;
+	if (mlfq==NULL){
+		out_of_memory(sim);
+	}
+	mlfq->run_queues=calloc(sim->cpus, sizeof(run_queue_t));
+	if (mlfq->run_queues==NULL){
+		out_of_memory(sim);
+	}
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		for (level=0; level<MAX_LEVELS; level++){
+			mlfq->run_queues[look_up].heads[level]=-1;
+			mlfq->run_queues[look_up].tails[level]=-1;
+		}
+	}
+	mlfq->next_boost=sim->boost_period>0 ? sim->boost_period : INT_MAX;
+	sim->policy_data=mlfq;
+}
+
+/*
+ * Function: mlfq_on_end
+ * -------------------
+ * frees the run queues and the levels of the simulation
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+static void mlfq_on_end(simulation_t *sim){
+	mlfq_t *mlfq=sim->policy_data;
+	free(mlfq->run_queues);
+	free(mlfq->links);
+	free(mlfq->levels);
+	free(mlfq->left);
+	free(mlfq->counted);
+	free(mlfq->boosts);
+	free(mlfq);
+	sim->policy_data=NULL;
+}
+
+/*
+ * Function: grow_places
+ * -------------------
+ * allocates the levels for as many places as the queue of the simulation has
+ *
+ * sim: the simulation
+ * mlfq: the run queues and the levels
+ *
+ * returns: none
+ */
+static void grow_places(simulation_t *sim, mlfq_t *mlfq){
+	mlfq->capacity=sim->capacity;
+	mlfq->links=realloc(mlfq->links, sizeof(int)*mlfq->capacity);
+	mlfq->levels=realloc(mlfq->levels, sizeof(int)*mlfq->capacity);
+	mlfq->left=realloc(mlfq->left, sizeof(int)*mlfq->capacity);
+	mlfq->counted=realloc(mlfq->counted, sizeof(int)*mlfq->capacity);
+	mlfq->boosts=realloc(mlfq->boosts, sizeof(int)*mlfq->capacity);
+	if (mlfq->links==NULL || mlfq->levels==NULL || mlfq->left==NULL || mlfq->counted==NULL || mlfq->boosts==NULL){
+		out_of_memory(sim);
+	}
+}
+
+/*
+ * Function: refresh
+ * -------------------
+ * moves the process back to the top level, if there was a boost since its level was set.
+ * The running time before the boost is no longer counted: at most the seconds since the
+ * boost are left to count.
+ *
+ * sim: the simulation
+ * mlfq: the run queues and the levels
+ * place: place of the process in the queue
+ * time: current time
+ *
+ * returns: none
+ */
+static void refresh(simulation_t *sim, mlfq_t *mlfq, int place, int time){
+	int remaining=sim->queue.remainingTime[place];
+	if (mlfq->boosts[place]==mlfq->boost){
+		return;
+	}
+	mlfq->boosts[place]=mlfq->boost;
+	mlfq->levels[place]=0;
+	mlfq->left[place]=sim->level_quanta[0];
+	if (mlfq->counted[place]-remaining>time-mlfq->last_boost){
+		mlfq->counted[place]=remaining+(time-mlfq->last_boost);
+	}
+}
+
+/*
+ * Function: boost
+ * -------------------
+ * once the boost period is over, moves all the waiting processes to the top level: the
+ * lists of the lower levels are added to the end of the top one, in order of the levels.
+ * If several periods passed since the last boost, they make a single one.
+ *
+ * sim: the simulation
+ * mlfq: the run queues and the levels
+ * time: current time
+ *
+ * returns: none
+ */
+static void boost(simulation_t *sim, mlfq_t *mlfq, int time){
+	run_queue_t *run_queue;
+	int look_up;
+	int level;
+	if (time<mlfq->next_boost){
+		return;
+	}
+	while (mlfq->next_boost<=time){
+		mlfq->last_boost=mlfq->next_boost;
+		mlfq->next_boost=mlfq->next_boost>INT_MAX-sim->boost_period ? INT_MAX : mlfq->next_boost+sim->boost_period;
+	}
+	mlfq->boost+=1;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		run_queue=&mlfq->run_queues[look_up];
+		for (level=1; level<sim->levels; level++){
+			if (run_queue->heads[level]==-1){
+				continue;
+			}
+			if (run_queue->heads[0]==-1){
+				run_queue->heads[0]=run_queue->heads[level];
+			}
+			else{
+				mlfq->links[run_queue->tails[0]]=run_queue->heads[level];
+			}
+			run_queue->tails[0]=run_queue->tails[level];
+			run_queue->heads[level]=-1;
+			run_queue->tails[level]=-1;
+		}
+	}
+}
+
+/*
+ * Function: push
+ * -------------------
+ * adds the process to the end of the list of the level
+ *
+ * mlfq: the run queues and the levels
+ * run_queue: the run queue
+ * level: the level
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+static void push(mlfq_t *mlfq, run_queue_t *run_queue, int level, int place){
+	mlfq->links[place]=-1;
+	if (run_queue->tails[level]==-1){
+		run_queue->heads[level]=place;
+	}
+	else{
+		mlfq->links[run_queue->tails[level]]=place;
+	}
+	run_queue->tails[level]=place;
+}
+
+/*
+ * Function: mlfq_on_arrival
+ * -------------------
+ * adds the process to the end of the top level of the run queue of the CPU, with the
+ * whole quantum of the level
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
+ *
+ * returns: none
+ */
+static void mlfq_on_arrival(simulation_t *sim, int cpu, int place, int time){
+	mlfq_t *mlfq=sim->policy_data;
+	if (place>=mlfq->capacity){
+		grow_places(sim, mlfq);
+	}
+	boost(sim, mlfq, time);
+	mlfq->levels[place]=0;
+	mlfq->left[place]=sim->level_quanta[0];
+	mlfq->counted[place]=sim->queue.remainingTime[place];
+	mlfq->boosts[place]=mlfq->boost;
+	push(mlfq, &mlfq->run_queues[cpu], 0, place);
+}
+
+/*
+ * Function: mlfq_select_next
+ * -------------------
+ * counts the seconds the running process has run since it was last looked at, moving it one
+ * level down once it used up the quantum of its level. Then finds the highest level with
+ * a waiting process: its first process runs next, if the level is higher than the level
+ * of the running process, or the same one and the running process used up its quantum.
+ * Otherwise the running process keeps running.
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * time: time, right at the moment when the process is being searched for
+ * running: process that is in a state of running (-1 if none)
+ *
+ * returns: the process to run, -1 if there are no processes
+ */
+static int mlfq_select_next(simulation_t *sim, int cpu, int time, int running){
+	mlfq_t *mlfq=sim->policy_data;
+	run_queue_t *run_queue=&mlfq->run_queues[cpu];
+	int used_up=0; //1 if the running process used up the quantum of its level
+	int level;
+	int place;
+
+	boost(sim, mlfq, time);
+	if (running!=-1){
+		refresh(sim, mlfq, running, time);
+		/*the seconds lost to switching are not taken from the quantum*/
+		mlfq->left[running]-=mlfq->counted[running]-sim->queue.remainingTime[running];
+		mlfq->counted[running]=sim->queue.remainingTime[running];
+		if (mlfq->left[running]<=0){
+			used_up=1;
+			if (mlfq->levels[running]<sim->levels-1){
+				mlfq->levels[running]+=1;
+			}
+			mlfq->left[running]=sim->level_quanta[mlfq->levels[running]];
+		}
+	}
+	/*the highest level with a waiting process*/
+	level=0;
+	while (level<sim->levels && run_queue->heads[level]==-1){
+		level+=1;
+	}
+	if (level==sim->levels){
+		return running;
+	}
+	if (running!=-1 && (level>mlfq->levels[running] || (level==mlfq->levels[running] && !used_up))){
+		return running;
+	}
+	place=run_queue->heads[level];
+	run_queue->heads[level]=mlfq->links[place];
+	if (run_queue->heads[level]==-1){
+		run_queue->tails[level]=-1;
+	}
+	refresh(sim, mlfq, place, time);
+	mlfq->counted[place]=sim->queue.remainingTime[place];
+	return place;
+}
+
+/*
+ * Function: mlfq_on_preempt
+ * -------------------
+ * puts the process, which was running, at the end of its level of the run queue of the CPU
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
+ *
+ * returns: none
+ */
+static void mlfq_on_preempt(simulation_t *sim, int cpu, int place, int time){
+	mlfq_t *mlfq=sim->policy_data;
+	push(mlfq, &mlfq->run_queues[cpu], mlfq->levels[place], place);
+}
+
+/*
+ * Function: mlfq_decide_at
+ * -------------------
+ * finds the time at which the running process uses up the quantum of its level, or the
+ * next boost, if it comes first: then another process may run, although nothing changed.
+ * The switch overhead the CPU still has to pay comes before the quantum.
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * running: process that is in a state of running (-1 if none)
+ * time: current time
+ *
+ * returns: the time, INT_MAX if no process is running
+ */
+static int mlfq_decide_at(simulation_t *sim, int cpu, int running, int time){
+	mlfq_t *mlfq=sim->policy_data;
+	long long seconds; //seconds until the running process uses up its quantum
+	int end;
+	if (running==-1){
+		return INT_MAX;
+	}
+	refresh(sim, mlfq, running, time);
+	seconds=(long long)mlfq->left[running]-(mlfq->counted[running]-sim->queue.remainingTime[running]);
+	if (seconds<0){
+		seconds=0;
+	}
+	seconds+=sim->cpu[cpu].overhead;
+	end=seconds>INT_MAX-time ? INT_MAX : time+seconds;
+	return end<mlfq->next_boost ? end : mlfq->next_boost;
+}
+
+/*
+ * Function: mlfq_save
+ * -------------------
+ * writes the levels, their quantums and the boost period, the state of the boosts, the
+ * levels of the processes and the lists of the run queues into the checkpoint
+ *
+ * sim: the simulation
+ * fp: the checkpoint file
+ *
+ * returns: none
+ */
+static void mlfq_save(simulation_t *sim, FILE *fp){
+	mlfq_t *mlfq=sim->policy_data;
+	int places=sim->rear<mlfq->capacity ? sim->rear : mlfq->capacity;
+	fwrite(&sim->levels, sizeof(int), 1, fp);
+	fwrite(sim->level_quanta, sizeof(int), MAX_LEVELS, fp);
+	fwrite(&sim->boost_period, sizeof(int), 1, fp);
+	fwrite(&mlfq->boost, sizeof(int), 1, fp);
+	fwrite(&mlfq->last_boost, sizeof(int), 1, fp);
+	fwrite(&mlfq->next_boost, sizeof(int), 1, fp);
+	fwrite(&places, sizeof(int), 1, fp);
+	fwrite(mlfq->links, sizeof(int), places, fp);
+	fwrite(mlfq->levels, sizeof(int), places, fp);
+	fwrite(mlfq->left, sizeof(int), places, fp);
+	fwrite(mlfq->counted, sizeof(int), places, fp);
+	fwrite(mlfq->boosts, sizeof(int), places, fp);
+	fwrite(mlfq->run_queues, sizeof(run_queue_t), sim->cpus, fp);
+}
+
+/*
+ * Function: mlfq_load
+ * -------------------
+ * reads what mlfq_save() wrote into the run queues, which were just created. The levels
+ * are to be the same as when the checkpoint was saved.
+ *
+ * sim: the simulation
+ * fp: the checkpoint file
+ *
+ * returns: none
+ */
+static void mlfq_load(simulation_t *sim, FILE *fp){
+	mlfq_t *mlfq=sim->policy_data;
+	int levels;
+	int level_quanta[MAX_LEVELS];
+	int boost_period;
+	int places;
+	int level;
+
+	read_part(fp, &levels, sizeof(int), 1);
+	read_part(fp, level_quanta, sizeof(int), MAX_LEVELS);
+	read_part(fp, &boost_period, sizeof(int), 1);
+	if (levels!=sim->levels || boost_period!=sim->boost_period){
+		printf("The checkpoint was saved with other options");
+		exit(0);
+	}
+	for (level=0; level<levels; level++){
+		if (level_quanta[level]!=sim->level_quanta[level]){
+			printf("The checkpoint was saved with other options");
+			exit(0);
+		}
+	}
+	read_part(fp, &mlfq->boost, sizeof(int), 1);
+	read_part(fp, &mlfq->last_boost, sizeof(int), 1);
+	read_part(fp, &mlfq->next_boost, sizeof(int), 1);
+	read_part(fp, &places, sizeof(int), 1);
+	if (places<0 || places>sim->capacity){
+		printf("The checkpoint file is damaged");
+		exit(0);
+	}
+	if (sim->capacity>0){
+		grow_places(sim, mlfq);
+	}
+	read_part(fp, mlfq->links, sizeof(int), places);
+	read_part(fp, mlfq->levels, sizeof(int), places);
+	read_part(fp, mlfq->left, sizeof(int), places);
+	read_part(fp, mlfq->counted, sizeof(int), places);
+	read_part(fp, mlfq->boosts, sizeof(int), places);
+	read_part(fp, mlfq->run_queues, sizeof(run_queue_t), sim->cpus);
+}
@@ -0,0 +1,1288 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ * 
+ * Simulation core shared by all the scheduling algorithms (see scheduler.h). It gets the 
+ * information about each process from the file, where each line represents a singe process 
+ * in form of:
+ * 		[Process Name] [Arrival Time] [Service Time] [Deadline] [Tickets]. 
+ *  It runs the processes the policy chooses on one or more CPUs, printing out the main events:
+ *		- when the new process enters
+ *		- when any of the processes finishes execution
+ *		- which process is currently running ( when any of the events above happen)
+ *
+ * Moreover, it saves information about each of the processes into results-N.txt
+ * (N depends on the policy) in form of:
+ * 		[Process name] [Wait time] [Turnaround Time] [Deadline Met]
+ * followed by the share deviation of the process, if it is asked for (see summarize()).
+ *
+ * All the state of a simulation is kept in simulation_t, so several simulations may
+ * run at the same time (see sweep.c).
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* string operations */
+#include <limits.h>     /* INT_MAX */
+#include <unistd.h>     /* ftruncate */
+#include "scheduler.h"
+
+/*forces a function to be inlined, so that it is specialized for the constant arguments it is called with*/
+#if defined(__GNUC__)
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define ALWAYS_INLINE inline
+#endif
+
+/*functions*/
+void *grow_array(simulation_t *sim, void *array, size_t size);
+int insert(simulation_t *sim, pcb_t *process);
+void delete(simulation_t *sim, int place);
+int next_process(simulation_t *sim, pcb_t *process);
+int least_loaded(simulation_t *sim);
+int busiest(simulation_t *sim);
+void dispatch(simulation_t *sim, int index, int time);
+static ALWAYS_INLINE void simulate_quantum(simulation_t *sim, int quantum);
+static ALWAYS_INLINE int quiet_time(simulation_t *sim, cpu_t *cpu, int time, int quantum);
+static ALWAYS_INLINE void share_time(simulation_t *sim, int seconds);
+int read_char(reader_t *reader);
+void summarize (simulation_t *sim, int place, int time);
+void summarize_cpus(simulation_t *sim, int time);
+void swap_in_heap(heap_t *heap, int first, int second);
+void sift_up(heap_t *heap, int position);
+void sift_down(heap_t *heap, int position);
+
+
+/*
+ * Function: init_simulation
+ * -------------------
+ * prepares the simulation of the given policy on the given number of CPUs, with an
+ * empty queue, the default quantum of the policy and the default levels (for MLFQ: 
+ * LEVELS levels, the quantum of the top one 1 second, doubling from one level to the next,
+ * and a boost every BOOST_PERIOD seconds). The events are printed out and 
+ * there is no results file until it is opened by open_results(). The processes are 
+ * to be given by setting either the reader or the trace.
+ *
+ * sim: simulation to be prepared
+ * policy: policy the processes are scheduled with
+ * cpus: number of the CPUs
+ *
+ * returns: none
+ */
+void init_simulation(simulation_t *sim, policy_t *policy, int cpus){
+	int look_up;
+	memset(sim, 0, sizeof(simulation_t));
+	sim->policy=policy;
+	sim->quantum=policy->quantum;
+	sim->cpus=cpus;
+	sim->format=TEXT;
+	sim->log_level=LOG_FULL;
+	sim->checkpoint_interval=CHECKPOINT_INTERVAL;
+	sim->results_offset=-1;
+	sim->levels=LEVELS;
+	for (look_up=0; look_up<LEVELS; look_up++){
+		sim->level_quanta[look_up]=1<<look_up;
+	}
+	sim->boost_period=BOOST_PERIOD;
+	sim->log_file=stdout;
+	sim->until=-1;
+}
+
+/*
+ * Function: free_simulation
+ * -------------------
+ * frees everything the simulation allocated (but not the reader or the trace)
+ *
+ * sim: simulation to be freed
+ *
+ * returns: none
+ */
+void free_simulation(simulation_t *sim){
+	process_table_t *queue=&sim->queue;
+	free(queue->remainingTime);
+	free(queue->entryTime);
+	free(queue->deadline);
+	free(queue->serviceTime);
+	free(queue->tickets);
+	free(queue->share_start);
+	free(queue->execTime);
+	free(queue->arrival);
+	free(queue->heap_place);
+	free(queue->cpu);
+	free(queue->run_queue);
+	free(queue->processname);
+	free(queue->live);
+	free(sim->free_places);
+	free(sim->log_buffer);
+	free(sim->cpu);
+	memset(queue, 0, sizeof(process_table_t));
+	sim->free_places=NULL;
+	sim->log_buffer=NULL;
+	sim->cpu=NULL;
+}
+
+/*
+ * Function: open_results
+ * -------------------
+ * opens the results file once for the whole simulation, clearing its content: 
+ * "results-N.txt" for the text format, "results-N.csv" (with a header line) for CSV and
+ * "results-N.bin" (result_t records) for the binary one, where N depends on the policy. 
+ * The file is fully buffered, so the summaries are written out in big blocks rather 
+ * than one line at a time.
+ *
+ * A resumed simulation (see checkpoint.c) keeps the content which was written before the
+ * checkpoint and cuts off the rest, so that the summaries written after the checkpoint
+ * are not there twice.
+ *
+ * sim: the simulation
+ * buffer_size: size of the buffer of the file in bytes
+ *
+ * returns: none
+ */
+void open_results(simulation_t *sim, long buffer_size){
+	char filename[32];
+	char *mode="w";
+	int number=sim->policy->results_number;
+	if (sim->format==CSV){
+		sprintf(filename, "results-%d.csv", number);
+	}
+	else if (sim->format==BINARY){
+		sprintf(filename, "results-%d.bin", number);
+		mode="wb";
+	}
+	else{
+		sprintf(filename, "results-%d.txt", number);
+	}
+	if (sim->resumed){
+		if (sim->results_offset<0){
+			printf("The checkpoint was saved without the results file");
+			exit(0);
+		}
+		sim->results=fopen(filename, sim->format==BINARY ? "r+b" : "r+");
+	}
+	else{
+		sim->results=fopen(filename, mode);
+	}
+	if (sim->results==NULL){
+		printf("The results file could not be open. Try again");
+		exit(0);
+	}
+	setvbuf(sim->results, NULL, _IOFBF, buffer_size);
+	if (sim->resumed){
+		if (ftruncate(fileno(sim->results), sim->results_offset)!=0 || fseek(sim->results, sim->results_offset, SEEK_SET)!=0){
+			printf("The results file could not be open. Try again");
+			exit(0);
+		}
+	}
+	if (sim->format==CSV && !sim->resumed && sim->fair_share){
+		fprintf(sim->results, "process,wait_time,turnaround_time,deadline_met,share_deviation\n");
+	}
+	else if (sim->format==CSV && !sim->resumed){
+		fprintf(sim->results, "process,wait_time,turnaround_time,deadline_met\n");
+	}
+}
+
+/*
+ * Function: close_results
+ * -------------------
+ * writes out what is left in the buffer and closes the results file
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+void close_results(simulation_t *sim){
+	fclose(sim->results);
+	sim->results=NULL;
+}
+
+/*
+ * Function: out_of_memory
+ * -------------------
+ * prints out the events so far and stops the simulation, since there is no memory
+ * left for the processes
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+void out_of_memory(simulation_t *sim){
+	flush_log(sim);
+	printf("There is not enough memory for the processes");
+	exit(0);
+}
+
+/*
+ * Function: grow_array
+ * -------------------
+ * changes the number of elements allocated for one array of the process table
+ *
+ * sim: the simulation
+ * array: the array
+ * size: size of an element
+ *
+ * returns: the array, which may have moved
+ */
+void *grow_array(simulation_t *sim, void *array, size_t size){
+	array=realloc(array, size*sim->capacity);
+	if (array==NULL){
+		out_of_memory(sim);
+	}
+	return array;
+}
+
+/*
+ * Function: grow_queue
+ * -------------------
+ * doubles the number of places allocated for the queue (and for the list of the 
+ * places to be reused), so that there is no limit on the number of processes. 
+ * Since the places of the finished processes are reused, the queue only grows 
+ * with the number of processes that are in the system at the same time.
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+void grow_queue(simulation_t *sim){
+	process_table_t *queue=&sim->queue;
+	int old_words=sim->capacity/WORD_BITS;
+	if (sim->capacity==0){
+		sim->capacity=INITIAL_CAPACITY;
+	}
+	else{
+		sim->capacity*=2;
+	}
+	queue->remainingTime=grow_array(sim, queue->remainingTime, sizeof(int));
+	queue->entryTime=grow_array(sim, queue->entryTime, sizeof(int));
+	queue->deadline=grow_array(sim, queue->deadline, sizeof(int));
+	queue->serviceTime=grow_array(sim, queue->serviceTime, sizeof(int));
+	queue->tickets=grow_array(sim, queue->tickets, sizeof(int));
+	queue->share_start=grow_array(sim, queue->share_start, sizeof(double));
+	queue->execTime=grow_array(sim, queue->execTime, sizeof(int));
+	queue->arrival=grow_array(sim, queue->arrival, sizeof(int));
+	queue->heap_place=grow_array(sim, queue->heap_place, sizeof(int));
+	queue->cpu=grow_array(sim, queue->cpu, sizeof(int));
+	queue->run_queue=grow_array(sim, queue->run_queue, sizeof(int));
+	queue->processname=grow_array(sim, queue->processname, NAME_SIZE);
+	sim->free_places=grow_array(sim, sim->free_places, sizeof(int));
+	/*the capacity is a multiple of the bits in a word, and all the new places are empty*/
+	queue->live=realloc(queue->live, sizeof(unsigned long)*(sim->capacity/WORD_BITS));
+	if (queue->live==NULL){
+		out_of_memory(sim);
+	}
+	memset(queue->live+old_words, 0, sizeof(unsigned long)*(sim->capacity/WORD_BITS-old_words));
+}
+
+/*
+ * Function: insert
+ * -------------------
+ * inserts the process into the queue, reusing the place of a finished process if there
+ * is one; otherwise places it after the rear, growing the queue if it is full.
+ * 
+ * sim: the simulation
+ * process: the process read from the file, which is to be inserted
+ *
+ * returns: place of the inserted process in the queue
+ */
+int insert(simulation_t *sim, pcb_t *process){
+	process_table_t *queue=&sim->queue;
+	int place;
+	if (sim->free_count>0){
+		sim->free_count-=1;
+		place=sim->free_places[sim->free_count];
+	}
+	else{
+		if (sim->rear==sim->capacity){
+			grow_queue(sim);
+		}
+		place=sim->rear;
+		sim->rear=sim->rear+1;
+	}
+	queue->remainingTime[place]=process->serviceTime;
+	queue->entryTime[place]=process->entryTime;
+	queue->deadline[place]=process->deadline;
+	queue->serviceTime[place]=process->serviceTime;
+	queue->tickets[place]=process->tickets;
+	queue->share_start[place]=sim->fair_time;
+	queue->execTime[place]=0;
+	queue->arrival[place]=sim->arrivals; //needed to keep the order of arrival, since places are reused
+	queue->heap_place[place]=-1;
+	queue->cpu[place]=-1; //it has not run yet
+	queue->run_queue[place]=-1;
+	memcpy(queue->processname[place], process->processname, NAME_SIZE);
+	sim->arrivals+=1;
+	sim->total_tickets+=process->tickets;
+	queue->live[place/WORD_BITS]|=1UL<<(place%WORD_BITS); // process is in the system once inserted
+	return place;
+}
+
+/*
+ * Function: delete
+ * -------------------
+ * removes the process from the queue by clearing its bit in the bitmap and keeping its 
+ * place to be reused by the next inserted process
+ *
+ * sim: the simulation
+ * place: position of the process to be deleted
+ *
+ * returns: none
+ */
+void delete(simulation_t *sim, int place){
+	sim->queue.live[place/WORD_BITS]&=~(1UL<<(place%WORD_BITS));
+	sim->total_tickets-=sim->queue.tickets[place];
+	sim->free_places[sim->free_count]=place;
+	sim->free_count+=1;
+}
+
+/*
+ * Function: next_process
+ * -------------------
+ * gets the next process of the simulation, either from the file or from the trace
+ *
+ * sim: the simulation
+ * process: process to be read into
+ *
+ * returns: 1 if there was a process, 0 at the end
+ */
+int next_process(simulation_t *sim, pcb_t *process){
+	if (sim->reader!=NULL){
+		return read_process(sim->reader, process);
+	}
+	if (sim->trace_position<sim->trace->count){
+		trace_process(sim->trace, sim->trace_position, process);
+		sim->trace_position+=1;
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * Function: least_loaded
+ * -------------------
+ * Finds the CPU with the fewest processes: the waiting ones and the running one. 
+ * If several CPUs have as few, the first of them is chosen.
+ *
+ * sim: the simulation
+ *
+ * returns: index of the CPU
+ */
+int least_loaded(simulation_t *sim){
+	cpu_t *cpu=sim->cpu;
+	int look_up;
+	int best=0;
+	int load;
+	int best_load=INT_MAX;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		load=cpu[look_up].waiting+(cpu[look_up].process_to_run!=-1);
+		if (load<best_load){
+			best_load=load;
+			best=look_up;
+		}
+	}
+	return best;
+}
+
+/*
+ * Function: busiest
+ * -------------------
+ * Finds the CPU with the most waiting processes in its run queue. If several CPUs 
+ * have as many, the first of them is chosen.
+ *
+ * sim: the simulation
+ *
+ * returns: index of the CPU, -1 if no process is waiting
+ */
+int busiest(simulation_t *sim){
+	cpu_t *cpu=sim->cpu;
+	int look_up;
+	int best=-1;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		if (cpu[look_up].waiting>0 && (best==-1 || cpu[look_up].waiting>cpu[best].waiting)){
+			best=look_up;
+		}
+	}
+	return best;
+}
+
+/*
+ * Function: dispatch
+ * -------------------
+ * asks the policy for the process to run next on the CPU. If the CPU is idle and its
+ * run queue is empty, it steals the process the busiest CPU would run next, so that no
+ * CPU is idle while processes are waiting. The running process, if it is replaced, 
+ * goes back to the run queue of the CPU. A process which last ran on another CPU 
+ * is counted as a migration. Starting to run another process costs the CPU the switch
+ * cost (and the migration cost for a migration), during which the process does not run.
+ *
+ * sim: the simulation
+ * index: index of the CPU
+ * time: current time
+ *
+ * returns: none
+ */
+void dispatch(simulation_t *sim, int index, int time){
+	char event[64]; //text of the event
+	policy_t *policy=sim->policy;
+	cpu_t *cpu=sim->cpu;
+	process_table_t *queue=&sim->queue;
+	int running=cpu[index].process_to_run;
+	int next=policy->select_next(sim, index, time, running); //search for the next process
+	int victim; //CPU the process is stolen from
+	
+	cpu[index].changed=0;
+	if (next!=running && next!=-1){
+		cpu[index].waiting-=1;
+		queue->run_queue[next]=-1;
+	}
+	/*an idle CPU with nothing to run takes work from the busiest one*/
+	if (next==-1){
+		victim=busiest(sim);
+		if (victim!=-1){
+			next=policy->select_next(sim, victim, time, -1);
+			cpu[victim].waiting-=1;
+			queue->run_queue[next]=-1;
+		}
+	}
+	if (next==running){
+		return;
+	}
+	if (running!=-1){
+		if (policy->on_preempt!=NULL){
+			policy->on_preempt(sim, index, running, time);
+		}
+		cpu[index].waiting+=1;
+		queue->run_queue[running]=index;
+	}
+	cpu[index].process_to_run=next;
+	if (next!=-1){
+		cpu[index].switches+=1;
+		cpu[index].overhead=sim->switch_cost;
+		if (queue->cpu[next]!=-1 && queue->cpu[next]!=index){
+			cpu[index].migrations+=1;
+			cpu[index].overhead+=sim->migration_cost;
+		}
+		queue->cpu[next]=index;
+		if (sim->cpus==1){
+			log_event(sim, time, queue->processname[next], "is in the running state", LOG_FULL);
+		}
+		else{
+			sprintf(event, "is in the running state on CPU %d", index);
+			log_event(sim, time, queue->processname[next], event, LOG_FULL);
+		}
+	}
+}
+
+/*
+ * Function: simulate
+ * -------------------
+ * works on scheduling the processes with the policy of the simulation on its CPUs. 
+ * takes the processes one by one, inserting them at their entry time into the run 
+ * queue of the least loaded CPU, while allowing other process to run, and then works 
+ * on the processes which remain in the system.
+ * every second the running process of every CPU runs; once the quantum is over or no 
+ * process is running on the CPU, the next process for it is searched for (see 
+ * dispatch()). the seconds in which the running processes simply keep running are 
+ * skipped at once (see quiet_time()), so the clock only stops when something happens.
+ *
+ * with legacy timing, the timing of the original FCFS program is kept: while there are
+ * processes still to enter, the CPU stays idle during the second after a completion, and 
+ * the second in which the last process enters is gone through twice.
+ *
+ * with more than one CPU, the busy time, utilization and migrations of every CPU are
+ * added to the results file at the end (see summarize_cpus()).
+ *
+ * the loop itself is in simulate_quantum(); it is compiled separately for the quantums
+ * which are used the most (0 for the policies which are not preemptive, 1 and 3), so that
+ * for them the quantum is a constant and the checks and divisions by it are worked out by
+ * the compiler. Any other quantum goes through the general version.
+ *
+ * with a checkpoint file, the state of the simulation is saved into it every now and then
+ * (see checkpoint.c); a simulation whose state was loaded from it goes on from there.
+ *
+ * in the service mode (see service.c), the simulation stops once the clock reaches the
+ * time to stop at, even if there are no processes, and goes on from there when it is
+ * called again, with the processes that were added to its trace meanwhile. The legacy
+ * timing does not go through the second of the last process twice then, since it is
+ * not known which process is the last one.
+ *
+ * a simulation of one shard of the trace (see shard.c) starts at the time its clock is
+ * set to instead of 0, and if more processes follow its trace, the legacy timing goes on
+ * as if they were still to enter.
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+void simulate(simulation_t *sim){
+	switch (sim->quantum){
+		case 0:
+			simulate_quantum(sim, 0);
+			break;
+		case 1:
+			simulate_quantum(sim, 1);
+			break;
+		case 3:
+			simulate_quantum(sim, 3);
+			break;
+		default:
+			simulate_quantum(sim, sim->quantum);
+	}
+}
+
+/*
+ * Function: simulate_quantum
+ * -------------------
+ * the simulation loop (see simulate()). As it is always inlined, every call with a 
+ * constant quantum produces a version of the loop specialized for that quantum.
+ *
+ * sim: the simulation
+ * quantum: seconds after which the next process is searched for, 0 if non-preemptive
+ *
+ * returns: none
+ */
+static ALWAYS_INLINE void simulate_quantum(simulation_t *sim, int quantum){
+	/* initialization*/
+	pcb_t process;
+	policy_t *policy=sim->policy;
+	cpu_t *cpu; //the simulated CPUs
+	int time=0; //current time in seconds
+	int look_up; //index of the CPU
+	int place; //place of the inserted process
+	int skip; //number of seconds to be skipped
+	int quiet; //number of seconds in which nothing happens on the CPU
+	int pending; //1 while the process read from the file has not entered yet
+	int repeat=0; //1 if the current second is gone through once more (legacy timing)
+	int process_to_run; //process running on the CPU
+	int *remaining; //remaining times of the processes in the system
+	long steps=0; //number of steps since the start or the last look at the wall time
+	
+	/*a resumed simulation goes on from the state in the checkpoint*/
+	if (sim->resumed){
+		cpu=sim->cpu;
+		time=sim->clock;
+		pending=sim->pending;
+		repeat=sim->repeat;
+		process=sim->next;
+		policy->on_start(sim);
+		restore_run_queues(sim, time);
+	}
+	/*a simulation which stopped to wait for more processes goes on from where it stopped*/
+	else if (sim->cpu!=NULL){
+		cpu=sim->cpu;
+		time=sim->clock;
+		pending=sim->pending;
+		repeat=sim->repeat;
+		process=sim->next;
+		if (!pending){
+			pending=next_process(sim, &process);
+		}
+	}
+	else{
+		cpu=calloc(sim->cpus, sizeof(cpu_t));
+		if (cpu==NULL){
+			out_of_memory(sim);
+		}
+		sim->cpu=cpu;
+		for (look_up=0; look_up<sim->cpus; look_up++){
+			cpu[look_up].process_to_run=-1; //-1 while there is no process to run
+			cpu[look_up].changed=1;
+			cpu[look_up].decide_at=INT_MAX;
+		}
+		time=sim->clock; //0, unless the simulation starts later (see shard.c)
+		policy->on_start(sim);
+		pending=next_process(sim, &process);
+	}
+	
+	/*while there is a process to enter or in the system (in the service mode, until the time to stop at)*/
+	while (pending || sim->rear-sim->free_count>0 || sim->until>=0){
+		/*the wall time is only looked at once in a while, so that checkpoints cost nothing in between*/
+		if (sim->checkpoint!=NULL){
+			steps+=1;
+			if (steps==CHECKPOINT_STEPS){
+				steps=0;
+				if (checkpoint_due(sim)){
+					sim->clock=time;
+					sim->pending=pending;
+					sim->repeat=repeat;
+					sim->next=process;
+					write_checkpoint(sim);
+				}
+			}
+		}
+		
+		/*jump over the seconds in which nothing happens on any of the CPUs*/
+		skip=INT_MAX;
+		for (look_up=0; look_up<sim->cpus; look_up++){
+			quiet=quiet_time(sim, &cpu[look_up], time, quantum);
+			if (quiet<skip){
+				skip=quiet;
+			}
+		}
+		if (pending && skip>process.entryTime-time){
+			skip=process.entryTime-time;
+		}
+		if (sim->until>=0 && skip>sim->until-time){
+			skip=sim->until-time;
+		}
+		if (skip>0){
+			for (look_up=0; look_up<sim->cpus; look_up++){
+				if (cpu[look_up].process_to_run!=-1){
+					sim->queue.remainingTime[cpu[look_up].process_to_run]-=skip;
+					cpu[look_up].busy_time+=skip;
+				}
+				if (quantum>0){
+					cpu[look_up].q=(cpu[look_up].q+skip)%quantum;
+				}
+			}
+			if (sim->fair_share){
+				share_time(sim, skip);
+			}
+			time+=skip;
+		}
+		/*the simulation stops at the given time, with all the seconds before it gone through*/
+		if (sim->until>=0 && time>=sim->until){
+			sim->clock=time;
+			sim->pending=pending;
+			sim->repeat=repeat;
+			sim->next=process;
+			return;
+		}
+		
+		/*insert the process once the time reaches it's enrty time*/
+		if (pending && process.entryTime <= time){
+			place=insert(sim, &process);
+			look_up=least_loaded(sim);
+			policy->on_arrival(sim, look_up, place, time);
+			sim->queue.run_queue[place]=look_up;
+			cpu[look_up].waiting+=1;
+			cpu[look_up].changed=1;
+			log_event(sim, process.entryTime, process.processname, "has entered the system", LOG_FULL);
+			pending=next_process(sim, &process);
+			if (!pending && !sim->follows && policy->legacy_timing && sim->until<0){
+				repeat=1;
+			}
+		}
+		
+		for (look_up=0; look_up<sim->cpus; look_up++){
+			//once the quantum is over, reinitialize it to 0 to look for a new process 
+			if (quantum>0 && cpu[look_up].q==quantum){
+				cpu[look_up].q=0;
+			}
+			//the policy may choose another process from this time on, even if nothing changed
+			if (time>=cpu[look_up].decide_at){
+				cpu[look_up].changed=1;
+			}
+			
+			//if the quantum is 0 or the current process is completed
+			if (((quantum>0 && cpu[look_up].q==0) || cpu[look_up].process_to_run==-1) && cpu[look_up].changed){
+				dispatch(sim, look_up, time);
+				if (policy->decide_at!=NULL){
+					cpu[look_up].decide_at=policy->decide_at(sim, look_up, cpu[look_up].process_to_run, time);
+				}
+			}
+			
+			process_to_run=cpu[look_up].process_to_run;
+			if (cpu[look_up].rest){
+				cpu[look_up].rest=0; //the CPU is idle during this second
+			}
+			else if (cpu[look_up].overhead>0){
+				/*the CPU is switching to the process, which does not run yet*/
+				cpu[look_up].overhead-=1;
+				cpu[look_up].lost_time+=1;
+			}
+			else if (process_to_run!=-1){
+				remaining=sim->queue.remainingTime;
+				//once the process started running for the 1st time, its exec time is recorded
+				if( remaining[process_to_run]== sim->queue.serviceTime[process_to_run]){
+					sim->queue.execTime[process_to_run]=time;
+				}
+				/*deduct one second, if remaining time is more than 0*/
+				if (remaining[process_to_run]!=0){
+					remaining[process_to_run]-=1;
+					cpu[look_up].busy_time+=1;
+				}
+			}
+		}
+		
+		//increment of the time and quantum
+		if (repeat){
+			repeat=0;
+		}
+		else{
+			if (sim->fair_share){
+				share_time(sim, 1);
+			}
+			time+=1;
+			for (look_up=0; look_up<sim->cpus; look_up++){
+				cpu[look_up].q+=1;
+			}
+		}
+		
+		/*once remaining time is 0, process has finished the execution*/
+		for (look_up=0; look_up<sim->cpus; look_up++){
+			process_to_run=cpu[look_up].process_to_run;
+			if (process_to_run!=-1 && sim->queue.remainingTime[process_to_run]==0){
+				log_event(sim, time, sim->queue.processname[process_to_run], "has finished execution", LOG_SUMMARY);
+				summarize(sim, process_to_run, time);
+				if (policy->on_complete!=NULL){
+					policy->on_complete(sim, look_up, process_to_run, time);
+				}
+				delete(sim, process_to_run); //process is removed from the queue
+				cpu[look_up].q=0; //reset quantum to 0, once the process is deleted
+				cpu[look_up].overhead=0;
+				cpu[look_up].process_to_run=-1;
+				cpu[look_up].changed=1;
+				if ((pending || sim->follows) && policy->legacy_timing){
+					cpu[look_up].rest=1;
+				}
+			}
+		}
+	}
+	sim->end_time=time;
+	if (sim->cpus>1){
+		summarize_cpus(sim, time);
+	}
+	policy->on_end(sim);
+}
+
+/*
+ * Function: quiet_time
+ * -------------------
+ * Counts the seconds from now on, in which nothing but the running process of the CPU
+ * progressing happens: it neither starts nor finishes, and the policy is not asked for 
+ * the next process in a way that could change it. Nothing that happened since the last 
+ * search (an entry or a completion) may change the choice of the policy only at the end 
+ * of the quantum; otherwise the policy would choose the running process again. 
+ * Entries of new processes are not taken into account. The seconds of a context switch
+ * are not skipped, since the process does not progress in them, and neither is the time
+ * at which the policy asked to choose again.
+ *
+ * sim: the simulation
+ * cpu: the CPU
+ * time: current time
+ * quantum: seconds after which the next process is searched for, 0 if non-preemptive
+ *
+ * returns: number of seconds that can be skipped
+ */
+static ALWAYS_INLINE int quiet_time(simulation_t *sim, cpu_t *cpu, int time, int quantum){
+	int skip;
+	int q=cpu->q;
+	int process_to_run=cpu->process_to_run;
+	/*if no process is running, the CPU is idle until a new process enters*/
+	if (process_to_run==-1){
+		if (cpu->changed){
+			return 0;
+		}
+		return INT_MAX;
+	}
+	/*the seconds of a context switch are gone through one by one*/
+	if (cpu->overhead>0){
+		return 0;
+	}
+	/*the first second of the execution is recorded as exec time*/
+	if (sim->queue.remainingTime[process_to_run]==sim->queue.serviceTime[process_to_run]){
+		return 0;
+	}
+	skip=sim->queue.remainingTime[process_to_run]-1; //the last second is when it finishes
+	/*the policy may choose another process once the time it gave the running one is over*/
+	if (skip>cpu->decide_at-time){
+		skip=cpu->decide_at>time ? cpu->decide_at-time : 0;
+	}
+	/*since something has changed, the search at the end of the quantum may pick another process*/
+	if (cpu->changed && quantum>0 && skip>(quantum-q%quantum)%quantum){
+		skip=(quantum-q%quantum)%quantum;
+	}
+	return skip;
+}
+
+/*
+ * Function: share_time
+ * -------------------
+ * adds the seconds that pass to the fair time, the CPU time a single ticket is entitled
+ * to: in a fair share, the processes in the system split the CPUs that have something
+ * to run, min(processes, CPUs) of them, by their tickets, so a ticket gets that many
+ * CPUs / all the tickets of a second every second. The processes in the system are the
+ * same during all the seconds.
+ *
+ * sim: the simulation
+ * seconds: number of seconds that pass
+ *
+ * returns: none
+ */
+static ALWAYS_INLINE void share_time(simulation_t *sim, int seconds){
+	long processes=sim->rear-sim->free_count;
+	if (processes>0){
+		sim->fair_time+=(double)seconds*(processes<sim->cpus ? processes : sim->cpus)/sim->total_tickets;
+	}
+}
+
+/*
+ * Function: swap_in_heap
+ * -------------------
+ * swaps two positions of the heap, keeping the positions stored in the processes up to date
+ *
+ * heap: heap to be changed
+ * first: first position in the heap
+ * second: second position in the heap
+ *
+ * returns: none
+ */
+void swap_in_heap(heap_t *heap, int first, int second){
+	int *heap_place=heap->sim->queue.heap_place;
+	int place=heap->places[first];
+	heap->places[first]=heap->places[second];
+	heap->places[second]=place;
+	heap_place[heap->places[first]]=first;
+	heap_place[heap->places[second]]=second;
+}
+
+/*
+ * Function: sift_up
+ * -------------------
+ * moves the process up the heap while it goes before its parent
+ *
+ * heap: heap to be changed
+ * position: position of the process in the heap
+ *
+ * returns: none
+ */
+void sift_up(heap_t *heap, int position){
+	int parent;
+	while (position>0){
+		parent=(position-1)/2;
+		if (!heap->is_before(heap->sim, heap->places[position], heap->places[parent])){
+			break;
+		}
+		swap_in_heap(heap, position, parent);
+		position=parent;
+	}
+}
+
+/*
+ * Function: sift_down
+ * -------------------
+ * moves the process down the heap while any of its children goes before it
+ *
+ * heap: heap to be changed
+ * position: position of the process in the heap
+ *
+ * returns: none
+ */
+void sift_down(heap_t *heap, int position){
+	int child;
+	while (2*position+1<heap->size){
+		child=2*position+1;
+		//picking the child which goes first
+		if (child+1<heap->size && heap->is_before(heap->sim, heap->places[child+1], heap->places[child])){
+			child+=1;
+		}
+		if (!heap->is_before(heap->sim, heap->places[child], heap->places[position])){
+			break;
+		}
+		swap_in_heap(heap, position, child);
+		position=child;
+	}
+}
+
+/*
+ * Function: heap_insert
+ * -------------------
+ * adds the process to the heap, doubling the places allocated for it if it is full
+ *
+ * heap: heap to be changed
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+void heap_insert(heap_t *heap, int place){
+	if (heap->size==heap->capacity){
+		if (heap->capacity==0){
+			heap->capacity=INITIAL_CAPACITY;
+		}
+		else{
+			heap->capacity*=2;
+		}
+		heap->places=realloc(heap->places, sizeof(int)*heap->capacity);
+		if (heap->places==NULL){
+			out_of_memory(heap->sim);
+		}
+	}
+	heap->places[heap->size]=place;
+	heap->sim->queue.heap_place[place]=heap->size;
+	heap->size+=1;
+	sift_up(heap, heap->size-1);
+}
+
+/*
+ * Function: heap_delete
+ * -------------------
+ * removes the process from the heap, putting the last process of the heap in its 
+ * position and moving it to where it belongs
+ *
+ * heap: heap to be changed
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+void heap_delete(heap_t *heap, int place){
+	int position=heap->sim->queue.heap_place[place];
+	heap->size-=1;
+	if (position!=heap->size){
+		swap_in_heap(heap, position, heap->size);
+		sift_up(heap, position);
+		sift_down(heap, position);
+	}
+}
+
+/*
+ * Function: open_reader
+ * -------------------
+ * creates the reader of the file, which is read in a single pass
+ *
+ * fp: file to be read from
+ *
+ * returns: the reader
+ */
+reader_t *open_reader(FILE *fp){
+	reader_t *reader= malloc(sizeof(reader_t)); //allocating space for the buffer
+	if (reader==NULL){
+		printf("There is not enough memory for the processes");
+		exit(0);
+	}
+	reader->fp=fp;
+	reader->size=0;
+	reader->position=0;
+	reader->offset=0;
+	return reader;
+}
+
+/*
+ * Function: read_char
+ * -------------------
+ * gets the next character of the file, reading the next part of it into the buffer
+ * once all the characters in the buffer are parsed
+ *
+ * reader: reader of the file
+ *
+ * returns: the next character, EOF at the end of the file
+ */
+int read_char(reader_t *reader){
+	if (reader->position==reader->size){
+		reader->offset+=reader->size;
+		reader->size=fread(reader->buffer, 1, BUFFER_SIZE, reader->fp);
+		reader->position=0;
+		if (reader->size==0){
+			return EOF;
+		}
+	}
+	reader->position+=1;
+	return (unsigned char) reader->buffer[reader->position-1];
+}
+
+/*
+ * Function: read_process
+ * -------------------
+ * reads the next line of the file into the process, in form of:
+ * 		[Process Name] [Arrival Time] [Service Time] [Deadline] [Tickets]
+ * the name is cut to 10 characters and the numbers are parsed by hand. Empty lines
+ * and lines with less than 4 fields are skipped, extra fields are ignored. The tickets
+ * may be left out, then the process has DEFAULT_TICKETS (as it has if they are not positive).
+ * since the file is read only once and one process at a time, it may also be a pipe.
+ *
+ * reader: reader of the file
+ * process: process to be read into
+ *
+ * returns: 1 if the process was read, 0 at the end of the file
+ */
+int read_process(reader_t *reader, pcb_t *process){
+	int fields=0; //number of fields read from the current line
+	int length; //length of the name
+	int number;
+	int sign;
+	int c=read_char(reader);
+	
+	while (c!=EOF){
+		/*end of the line*/
+		if (c=='\n'){
+			if (fields>=4){
+				return 1;
+			}
+			fields=0; //the line is not complete, so it is skipped
+			c=read_char(reader);
+		}
+		else if (c==' ' || c=='\t' || c=='\r'){
+			c=read_char(reader);
+		}
+		/*the first field is the name*/
+		else if (fields==0){
+			length=0;
+			while (c!=EOF && c!=' ' && c!='\t' && c!='\r' && c!='\n'){
+				if (length<10){
+					process->processname[length]=c;
+					length+=1;
+				}
+				c=read_char(reader);
+			}
+			process->processname[length]='\0';
+			process->tickets=DEFAULT_TICKETS;
+			fields=1;
+		}
+		/*the rest of the fields are the numbers*/
+		else{
+			number=0;
+			sign=1;
+			if (c=='-'){
+				sign=-1;
+				c=read_char(reader);
+			}
+			while (c>='0' && c<='9'){
+				number=number*10+(c-'0');
+				c=read_char(reader);
+			}
+			//skipping the rest of the field, if it is not a number
+			while (c!=EOF && c!=' ' && c!='\t' && c!='\r' && c!='\n'){
+				c=read_char(reader);
+			}
+			if (fields==1){
+				process->entryTime=sign*number;
+			}
+			else if (fields==2){
+				process->serviceTime=sign*number;
+			}
+			else if (fields==3){
+				process->deadline=sign*number;
+			}
+			else if (fields==4 && sign*number>0){
+				process->tickets=number;
+			}
+			fields+=1;
+		}
+	}
+	/*the last line may not end with a new line*/
+	return fields>=4;
+}
+
+/*
+ * Function: log_event
+ * -------------------
+ * adds the event to the buffer of the events, in form of:
+ * 		Time [time]: [Process name] [event]
+ * with the name right-aligned in 10 characters. The numbers are formatted by hand and 
+ * the buffer is printed out only once it is full (or at the end), so that printing 
+ * does not slow down the simulation. Events above the chosen log level are skipped.
+ *
+ * sim: the simulation
+ * time: time of the event
+ * processname: name of the process
+ * event: what happened to the process
+ * level: lowest log level, at which the event is printed out
+ *
+ * returns: none
+ */
+void log_event(simulation_t *sim, int time, char *processname, char *event, log_level_t level){
+	char digits[12];
+	char *log_buffer;
+	int log_size;
+	int count=0;
+	int length=strlen(processname);
+	unsigned int number=time<0 ? -(unsigned int)time : (unsigned int)time;
+	
+	if (level>sim->log_level){
+		return;
+	}
+	/*the buffer is only allocated once there is an event to be printed out*/
+	if (sim->log_buffer==NULL){
+		sim->log_buffer=malloc(LOG_BUFFER_SIZE);
+		if (sim->log_buffer==NULL){
+			out_of_memory(sim);
+		}
+	}
+	/*making sure that the line fits into the buffer*/
+	if (sim->log_size+64+strlen(event)>LOG_BUFFER_SIZE){
+		flush_log(sim);
+	}
+	log_buffer=sim->log_buffer;
+	log_size=sim->log_size;
+	memcpy(log_buffer+log_size, "Time ", 5);
+	log_size+=5;
+	if (time<0){
+		log_buffer[log_size]='-';
+		log_size+=1;
+	}
+	/*digits of the time are found from the last one*/
+	do{
+		digits[count]='0'+number%10;
+		number/=10;
+		count+=1;
+	} while (number>0);
+	while (count>0){
+		count-=1;
+		log_buffer[log_size]=digits[count];
+		log_size+=1;
+	}
+	log_buffer[log_size]=':';
+	log_size+=1;
+	/*the name is right-aligned in 10 characters, after the space*/
+	while (length<11){
+		log_buffer[log_size]=' ';
+		log_size+=1;
+		length+=1;
+	}
+	length=strlen(processname);
+	memcpy(log_buffer+log_size, processname, length);
+	log_size+=length;
+	log_buffer[log_size]=' ';
+	log_size+=1;
+	length=strlen(event);
+	memcpy(log_buffer+log_size, event, length);
+	log_size+=length;
+	log_buffer[log_size]='\n';
+	log_size+=1;
+	sim->log_size=log_size;
+}
+
+/*
+ * Function: flush_log
+ * -------------------
+ * prints out the events in the buffer
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+void flush_log(simulation_t *sim){
+	if (sim->log_size>0){
+		fwrite(sim->log_buffer, 1, sim->log_size, sim->log_file);
+	}
+	fflush(sim->log_file);
+	sim->log_size=0;
+}
+
+/*
+ * Function: summarize
+ * -------------------
+ * Calculates process's wait time, turnaround time and determines whether the 
+ * deadline was met, adding them to the totals and the sketches of the simulation 
+ * (see metrics.c). Writes all that information about the process to the results file (if there is one), 
+ * in its format
+ *
+ * The original FCFS program measured the wait time as turnaround time - service time,
+ * which is kept with legacy timing.
+ *
+ * If it is asked for, the share deviation of the process is added to the line: how much
+ * more CPU time the process got than its fair share while it was in the system (see
+ * share_time()), relative to the fair share; 0 if it was exactly fair, below 0 if it
+ * got less. The binary records do not have it.
+ *
+ * sim: the simulation
+ * place: place of the process, that summary is about
+ * time: time, when the process completed execution
+ *
+ * returns: none
+ */
+void summarize (simulation_t *sim, int place, int time){
+	/*Initialization*/
+	process_table_t *queue=&sim->queue;
+	char *processname=queue->processname[place];
+	int deadline_satisfied=0;
+	int wait_time;
+	int turnaround_time;
+	double fair; //CPU time the process was entitled to
+	double deviation=0; //share deviation of the process
+	double absolute; //share deviation as an absolute value
+	result_t result;
+	
+	turnaround_time=time-queue->entryTime[place]; //calculating the turnaround time
+	//calculating the wait time
+	if (sim->policy->legacy_timing){
+		wait_time=turnaround_time-queue->serviceTime[place];
+	}
+	else{
+		wait_time=queue->execTime[place]-queue->entryTime[place];
+	}
+	/*Determining whether the deadline is satisfied*/
+	if (turnaround_time<=queue->deadline[place]){
+		deadline_satisfied = 1;
+	}
+	sim->finished+=1;
+	sim->total_wait+=wait_time;
+	sim->total_turnaround+=turnaround_time;
+	sim->deadlines_met+=deadline_satisfied;
+	sketch_add(&sim->wait_times, wait_time);
+	sketch_add(&sim->turnaround_times, turnaround_time);
+	if (sim->fair_share){
+		fair=queue->tickets[place]*(sim->fair_time-queue->share_start[place]);
+		if (fair>0){
+			deviation=(queue->serviceTime[place]-fair)/fair;
+		}
+		absolute=deviation<0 ? -deviation : deviation;
+		sim->total_deviation+=absolute;
+		if (absolute>sim->max_deviation){
+			sim->max_deviation=absolute;
+		}
+	}
+	// Adding the summary to the file
+	if (sim->results==NULL){
+		return;
+	}
+	if (sim->format==BINARY){
+		memset(&result, 0, sizeof(result_t));
+		strcpy(result.processname, processname);
+		result.wait_time=wait_time;
+		result.turnaround_time=turnaround_time;
+		result.deadline_met=deadline_satisfied;
+		fwrite(&result, sizeof(result_t), 1, sim->results);
+	}
+	else if (sim->format==CSV && sim->fair_share){
+		fprintf(sim->results, "%s,%d,%d,%d,%.4f\n", processname, wait_time, turnaround_time, deadline_satisfied, deviation);
+	}
+	else if (sim->format==CSV){
+		fprintf(sim->results, "%s,%d,%d,%d\n", processname, wait_time, turnaround_time, deadline_satisfied);
+	}
+	else if (sim->fair_share){
+		fprintf(sim->results, "%s %d %d %d %.4f\n", processname, wait_time, turnaround_time, deadline_satisfied, deviation);
+	}
+	else{
+		fprintf(sim->results, "%s %d %d %d\n", processname, wait_time, turnaround_time, deadline_satisfied);
+	}
+}
+
+/*
+ * Function: summarize_cpus
+ * -------------------
+ * Writes the busy time (number of seconds in which the CPU was running a process),
+ * the utilization (busy time / time of the simulation) and the number of migrations
+ * of every CPU to the results file, after the summaries of the processes: in form of
+ * 		CPU-[index] [Busy time] [Utilization] [Migrations]
+ * for the text format and as a second table for CSV. The binary format only has the 
+ * records of the processes.
+ *
+ * sim: the simulation
+ * time: time, when the last process completed execution
+ *
+ * returns: none
+ */
+void summarize_cpus(simulation_t *sim, int time){
+	cpu_t *cpu=sim->cpu;
+	int look_up;
+	double utilization;
+	
+	if (sim->results==NULL || sim->format==BINARY){
+		return;
+	}
+	if (sim->format==CSV){
+		fprintf(sim->results, "\ncpu,busy_time,utilization,migrations\n");
+	}
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		utilization=0;
+		if (time>0){
+			utilization=(double)cpu[look_up].busy_time/time;
+		}
+		if (sim->format==CSV){
+			fprintf(sim->results, "%d,%ld,%.4f,%d\n", look_up, cpu[look_up].busy_time, utilization, cpu[look_up].migrations);
+		}
+		else{
+			fprintf(sim->results, "CPU-%d %ld %.4f %d\n", look_up, cpu[look_up].busy_time, utilization, cpu[look_up].migrations);
+		}
+	}
+}
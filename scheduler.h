@@ -0,0 +1,345 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ * 
+ * Simulation core shared by all the scheduling algorithms. The core reads the processes,
+ * keeps them in the queue, moves the clock from event to event, prints out the events and
+ * writes the results file. The scheduling algorithms themselves are policies (policy_t),
+ * which only decide which process runs next, so any improvement of the core is shared by
+ * all of them.
+ */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdio.h>      /* standard I/O routines */
+#define INITIAL_CAPACITY 64 //number of places the queue starts with
+#define BUFFER_SIZE 65536 //number of characters read from the file at once
+#define RESULTS_BUFFER_SIZE 1048576 //default size of the buffer of the results file
+#define LOG_BUFFER_SIZE 1048576 //size of the buffer the events are written into
+#define NAME_SIZE 11 //size of the name of a process, with the terminating null character
+#define WORD_BITS (8*sizeof(unsigned long)) //number of places in a word of the bitmap
+#define SMALL_QUEUE_SIZE 32 //run queues of up to this many processes are searched without a heap
+#define SKETCH_BITS 6 //highest bits of a value that are kept by the quantile sketch
+#define SKETCH_PRECISION (1<<SKETCH_BITS) //buckets for every power of 2
+#define SKETCH_BUCKETS ((32-SKETCH_BITS)*SKETCH_PRECISION) //buckets needed for any positive int
+#define CHECKPOINT_INTERVAL 60 //default number of seconds of wall time between two checkpoints
+#define CHECKPOINT_STEPS 65536 //number of steps of the simulation between two looks at the wall time
+#define MAX_LEVELS 16 //maximum number of priority levels (MLFQ)
+#define LEVELS 4 //default number of priority levels, the quantum doubling from one level to the next
+#define BOOST_PERIOD 100 //default number of seconds after which all the processes go back to the top level
+#define DEFAULT_TICKETS 100 //tickets of a process whose line has none
+#define STRIDE1 (1<<20) //stride of a process with a single ticket (stride)
+#define WHEEL_BITS 8 //bits of the time told apart by each level of the timing wheel
+#define WHEEL_SLOTS (1<<WHEEL_BITS) //slots of each level of the timing wheel
+#define WHEEL_LEVELS 4 //levels of the timing wheel, enough for any time that fits in an int
+#define SORT_MEMORY (64L*1024*1024) //default number of bytes the processes are sorted in (see sort.c)
+#define MERGE_WAYS 64 //most sorted runs merged at once by the sort
+#define MIN_RUN_BUFFER 4096 //smallest buffer of a run of the sort; fewer runs are merged at once rather than the buffers getting smaller
+#define SHARDS_PER_JOB 4 //shards the trace is split into for every thread, so that the threads finish at about the same time
+#define MIN_SHARD_SIZE 4096 //fewest processes in a shard of the trace
+#define TIMER_MIN_REMAINING 64 //waiting processes with this many seconds left to run get a timer for their deadline (deadline)
+
+
+
+/*Which events are printed out: none, only the completions or all of them*/
+typedef enum {
+	LOG_OFF, LOG_SUMMARY, LOG_FULL
+} log_level_t;
+
+/*What is written about the processes: a line per process in the results file, a summary or both*/
+typedef enum {
+	RESULTS_LINES, RESULTS_SUMMARY, RESULTS_BOTH
+} results_t;
+
+/*Format of the results file*/
+typedef enum {
+	TEXT, CSV, BINARY
+} format_t;
+
+/*Record of the binary results file, one per process*/
+typedef struct{
+	char processname[12]; // A string that identifies the process
+	int wait_time;
+	int turnaround_time;
+	int deadline_met; //1 if met, 0 otherwise
+} result_t;
+
+/* Process as it is read from the file. Once it enters the system, its fields are
+copied into the process table of the simulation*/
+typedef struct{
+	char processname[NAME_SIZE]; // A string that identifies the process
+
+	/*Times are measured in seconds*/
+	int entryTime; // The time process enteres system
+	int serviceTime; //The total CPU time required by the process
+	int deadline; //The expected turnaround time
+	int tickets; //share of the CPU the process is entitled to, relative to the other processes
+} pcb_t;
+
+/* Process control blocks of the processes in the system, kept as one array per field
+(structure of arrays) and indexed by the place of the process. The fields the policies
+compare lie next to each other for all the processes, so going through them touches as
+few cache lines as possible; the names, only needed for the output, are in a table of
+their own, and which places hold a process is kept in a bitmap*/
+typedef struct{
+	/*Times are measured in seconds*/
+	int *remainingTime; //Remaining service time until completion
+	int *entryTime; // The time process enteres system
+	int *deadline; //The expected turnaround time
+	int *serviceTime; //The total CPU time required by the process
+	int *tickets; //share of the CPU the process is entitled to
+	double *share_start; //fair time per ticket when the process entered the system
+	int *execTime; //The time when process started execution
+	int *arrival; //The order in which the process entered the system
+	int *heap_place; //Position of the process in the heap it is in (used by the policies)
+	int *cpu; //CPU the process last ran on, -1 if it has not run yet
+	int *run_queue; //CPU in whose run queue the process waits, -1 while it runs
+	char (*processname)[NAME_SIZE]; //names of the processes
+	unsigned long *live; //bit of the place is set while it holds a process in the system
+} process_table_t;
+
+/*whether the place of the process table holds a process in the system*/
+#define IS_LIVE(table, place) (((table)->live[(place)/WORD_BITS]>>((place)%WORD_BITS))&1UL)
+
+/* Buffered reader of the file with processes, which parses it in a single pass*/
+typedef struct{
+	FILE *fp; //file to be read from
+	char buffer[BUFFER_SIZE]; //characters read from the file at once
+	int size; //number of characters in the buffer
+	int position; //position of the next character to be parsed
+	long offset; //position in the file of the first character in the buffer
+} reader_t;
+
+typedef struct simulation simulation_t;
+
+/* Min-heap of places in the queue of the simulation, ordered by the given comparison function*/
+typedef struct{
+	int *places; //places of the processes in the queue
+	int size; //number of processes in the heap
+	int capacity; //number of places allocated for the heap
+	int (*is_before)(simulation_t *sim, int first, int second); //whether the first process goes before the second
+	simulation_t *sim; //simulation the processes belong to
+} heap_t;
+
+/* Run queue of a few processes, kept as arrays in order of arrival (see small_queue.c)*/
+typedef struct{
+	int *places; //places of the processes in the queue
+	int *keys; //what the processes are compared by, smaller first
+	int *ties; //what the processes are compared by if the keys are the same
+	int *limits; //latest time at which each process may still be chosen
+	int size; //number of processes in the run queue
+	int capacity; //number of processes allocated for
+} small_queue_t;
+
+/* Timer of a place of the queue in the timing wheel*/
+typedef struct{
+	int next; //next timer in the slot, -1 if it is the last one
+	int previous; //previous timer in the slot, -1 if it is the first one
+	int expiry; //time at which the timer expires
+	int slot; //slot the timer is in (level * WHEEL_SLOTS + slot), -1 if the place has no timer
+} wheel_timer_t;
+
+/* Hierarchical timing wheel of timers, at most one for each place of the queue (see
+timing_wheel.c). A timer is added and cancelled in O(1) time, and expires once the wheel
+is advanced to its time*/
+typedef struct{
+	int heads[WHEEL_LEVELS][WHEEL_SLOTS]; //first timer of every slot, -1 if the slot is empty
+	unsigned long occupied[WHEEL_LEVELS][WHEEL_SLOTS/WORD_BITS]; //bit of the slot is set while it has timers
+	wheel_timer_t *timers; //timers of the places
+	int capacity; //number of places allocated for
+	int now; //time the wheel was advanced to
+	int due; //no slot with timers starts before this time, so the wheel has nothing to do until then
+	int count; //number of timers in the wheel
+} timing_wheel_t;
+
+/* Quantile sketch of a set of values: a histogram whose buckets get wider as the values get
+bigger, so that any quantile is found within 1/128 of its value (see metrics.c)*/
+typedef struct{
+	long buckets[SKETCH_BUCKETS]; //number of values in each bucket
+	long count; //number of values
+	long sum; //sum of the values
+	int min; //smallest value
+	int max; //biggest value
+} sketch_t;
+
+/* Simulated CPU. Each CPU runs one process at a time and has its own run queue, kept by the policy*/
+typedef struct{
+	int process_to_run; //process running on the CPU, -1 if none
+	int q; //quantum counter
+	int changed; //shows whether any process entered its run queue or finished on it since the last search
+	int rest; //1 if the CPU stays idle during the next second (legacy timing)
+	int waiting; //number of processes in its run queue
+	long busy_time; //number of seconds in which the CPU was running a process
+	int migrations; //number of processes which moved to this CPU from another one
+	long switches; //number of times the CPU started to run another process
+	int overhead; //seconds left of the context switch the CPU is doing
+	long lost_time; //number of seconds the CPU spent on context switches
+	int decide_at; //time at which the policy may choose another process even if nothing changed, INT_MAX if never
+} cpu_t;
+
+/* Scheduling algorithm, plugged into the simulation core. The policy keeps a run queue
+of the waiting processes for every CPU (in the policy data of the simulation). The process
+which is running is never in it: select_next() takes the chosen one out of the run queue 
+and on_preempt() gives the running one back once another one is chosen*/
+typedef struct{
+	char *name; //name of the policy on the command line
+	int results_number; //the results are written to results-[results number].txt
+	int quantum; //default number of seconds after which the next process is searched for, 0 if non-preemptive
+	int fixed_quantum; //1 if -q does not change the quantum (the policy is not preemptive, or chooses the times itself)
+	int legacy_timing; //1 to keep the timing of the original FCFS program (see simulate())
+	void (*on_start)(simulation_t *sim); //the simulation starts, the run queues are to be created
+	void (*on_arrival)(simulation_t *sim, int cpu, int place, int time); //the process entered the run queue of the CPU
+	int (*select_next)(simulation_t *sim, int cpu, int time, int running); //returns the process to run next on the CPU (-1 if none)
+	void (*on_preempt)(simulation_t *sim, int cpu, int place, int time); //the running process was replaced by another one (may be NULL)
+	void (*on_complete)(simulation_t *sim, int cpu, int place, int time); //the running process finished the execution (may be NULL)
+	void (*on_end)(simulation_t *sim); //the simulation ended, the run queues are to be freed
+	int (*decide_at)(simulation_t *sim, int cpu, int running, int time); //time at which the policy may choose another process for the CPU although nothing entered or finished (may be NULL)
+	void (*save)(simulation_t *sim, FILE *fp); //writes the run queues into the checkpoint (may be NULL, then they are built again from the waiting processes)
+	void (*load)(simulation_t *sim, FILE *fp); //reads the run queues from the checkpoint, once they are created
+} policy_t;
+
+/* Processes read from the file in advance, which may be shared by several simulations.
+They are kept in columns, either read from a text file or mapped from a binary trace file
+(see trace.c)*/
+typedef struct{
+	int count; //number of processes
+	int *entryTime; //entry times of the processes in order of the file
+	int *serviceTime; //service times of the processes
+	int *deadline; //deadlines of the processes
+	int *tickets; //tickets of the processes, NULL if the file has none (DEFAULT_TICKETS each)
+	unsigned int *name_offsets; //the name of a process goes from its offset to the next one
+	char *names; //characters of all the names
+	unsigned int names_size; //number of characters of all the names
+	int capacity; //number of processes allocated for, when the columns are read from a text file
+	unsigned int names_capacity; //number of characters allocated for the names
+	void *mapping; //the binary trace file mapped into memory, NULL if read from a text file
+	size_t mapping_size; //size of the mapping
+} trace_t;
+
+/* Writer of a binary trace file whose size is known in advance, so that the processes are
+written one by one, each of its fields into its own column (see trace.c)*/
+typedef struct{
+	FILE *columns[6]; //streams writing into the header and entry times, the service times, the deadlines, the tickets, the offsets and the names
+	unsigned int name_offset; //offset of the end of the names written so far
+	char *buffers; //buffers of the streams, one after another
+} trace_writer_t;
+
+/* State of one simulation. Nothing is shared between simulations, apart from the trace,
+which is only read, so several of them may run at the same time*/
+struct simulation{
+	policy_t *policy; //policy the processes are scheduled with
+	void *policy_data; //run queues of the CPUs, kept by the policy
+	int quantum; //seconds after which the next process is searched for, 0 if non-preemptive
+	int cpus; //number of the CPUs
+	cpu_t *cpu; //the simulated CPUs
+	int switch_cost; //seconds a CPU spends on starting to run another process
+	int migration_cost; //seconds it spends on top of that if the process last ran on another CPU
+	int levels; //number of priority levels (MLFQ)
+	int level_quanta[MAX_LEVELS]; //seconds a process may run at each level before it moves down
+	int boost_period; //seconds after which all the processes go back to the top level, 0 if never
+	int fair_share; //1 if the share deviation of the processes is reported
+	
+	/*processes in the system*/
+	process_table_t queue; //places for the processes in the system
+	int capacity; //number of places allocated for the queue
+	int rear; //points after the last place of the queue that was ever used
+	int *free_places; //places of the finished processes, which are to be reused
+	int free_count; //number of places to be reused
+	int arrivals; //number of processes that entered the system
+	long total_tickets; //tickets of the processes in the system
+	double fair_time; //CPU seconds a single ticket was entitled to since the start
+	
+	/*where the processes come from: the reader of the file or the trace*/
+	reader_t *reader; //reader of the file, NULL if the processes are taken from the trace
+	trace_t *trace; //processes read in advance
+	int trace_position; //position of the next process in the trace
+	int until; //time at which the simulation stops to wait for more processes (service mode), -1 to go on until all of them finished
+	int follows; //1 if more processes follow the trace, which are simulated separately (see shard.c)
+	
+	/*output*/
+	FILE *results; //file the summaries of the processes are written to, NULL if none
+	format_t format; //format of the results file
+	log_level_t log_level; //which events are printed out
+	FILE *log_file; //file the events are printed out to, stdout by default
+	char *log_buffer; //events, which are still to be printed out
+	int log_size; //number of characters in the buffer of the events
+	
+	/*totals of the finished processes*/
+	long finished; //number of finished processes
+	long total_wait; //sum of the wait times
+	long total_turnaround; //sum of the turnaround times
+	long deadlines_met; //number of processes which met the deadline
+	int end_time; //time when the last process finished
+	sketch_t wait_times; //wait times of the finished processes
+	sketch_t turnaround_times; //turnaround times of the finished processes
+	double total_deviation; //sum of the share deviations, as absolute values
+	double max_deviation; //biggest share deviation, as an absolute value
+	
+	/*checkpoints of the simulation (see checkpoint.c)*/
+	char *checkpoint; //file the state is saved to, NULL if it is not saved
+	int checkpoint_interval; //seconds of wall time between two checkpoints
+	double next_checkpoint; //wall time of the next checkpoint, 0 before the first look at it
+	int resumed; //1 if the state was loaded from the checkpoint
+	FILE *resume_file; //the checkpoint file, until the run queues are loaded from it
+	long results_offset; //size of the results file at the checkpoint, -1 if there was none
+	int clock; //current time, when the state is saved or loaded, or when the simulation starts
+	int pending; //1 if the next process was read but has not entered yet
+	int repeat; //1 if the current second is gone through once more (legacy timing)
+	pcb_t next; //the next process
+};
+
+/*policies*/
+extern policy_t fcfs_policy;
+extern policy_t srtn_policy;
+extern policy_t deadline_policy;
+extern policy_t mlfq_policy;
+extern policy_t stride_policy;
+
+/*functions*/
+void init_simulation(simulation_t *sim, policy_t *policy, int cpus);
+void simulate(simulation_t *sim);
+void free_simulation(simulation_t *sim);
+reader_t *open_reader(FILE *fp);
+int read_process(reader_t *reader, pcb_t *process);
+void read_trace(FILE *fp, trace_t *trace);
+void append_trace(trace_t *trace, pcb_t *process);
+int map_trace(char *filename, trace_t *trace);
+void write_trace(trace_t *trace, char *filename);
+void free_trace(trace_t *trace);
+void open_trace_writer(trace_writer_t *writer, char *filename, int count, unsigned int names_size, long buffer_size);
+void write_trace_process(trace_writer_t *writer, pcb_t *process);
+void close_trace_writer(trace_writer_t *writer);
+void sort_trace(FILE *fp, trace_t *trace, long memory);
+void trace_process(trace_t *trace, int index, pcb_t *process);
+void open_results(simulation_t *sim, long buffer_size);
+void close_results(simulation_t *sim);
+void log_event(simulation_t *sim, int time, char *processname, char *event, log_level_t level);
+void flush_log(simulation_t *sim);
+void out_of_memory(simulation_t *sim);
+void grow_queue(simulation_t *sim);
+int checkpoint_due(simulation_t *sim);
+void write_checkpoint(simulation_t *sim);
+void read_checkpoint(simulation_t *sim, char *filename);
+void restore_run_queues(simulation_t *sim, int time);
+void read_part(FILE *fp, void *part, size_t size, size_t count);
+void heap_insert(heap_t *heap, int place);
+void heap_delete(heap_t *heap, int place);
+void small_insert(simulation_t *sim, small_queue_t *small, int place, int key, int tie, int limit);
+int small_remove(small_queue_t *small, int position);
+void small_free(small_queue_t *small);
+int find_first_min(const int *keys, const int *ties, const int *limits, int time, int count);
+void wheel_init(timing_wheel_t *wheel);
+int wheel_add(simulation_t *sim, timing_wheel_t *wheel, int place, int expiry);
+void wheel_cancel(timing_wheel_t *wheel, int place);
+int wheel_expire(timing_wheel_t *wheel, int time);
+void wheel_free(timing_wheel_t *wheel);
+void sketch_add(sketch_t *sketch, int value);
+void sketch_merge(sketch_t *sketch, sketch_t *other);
+int sketch_quantile(sketch_t *sketch, double share);
+double sketch_mean(sketch_t *sketch);
+void print_summary(simulation_t *sim);
+void serve(char *path, simulation_t *settings);
+void simulate_shards(simulation_t *sim, int jobs);
+void sweep(trace_t *trace, policy_t **policies, int policy_count, int *quanta, int quantum_count, int *cpu_counts, int cpu_count, int jobs, simulation_t *settings);
+
+#endif
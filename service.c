@@ -0,0 +1,346 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Service mode: instead of simulating a file and exiting, the program waits for clients
+ * on a Unix domain socket, and simulates the processes they send while they send them,
+ * so that a policy can be used live, e.g. the deadline-driven one as an admission oracle.
+ * A client sends messages, each of them its length (a 4-byte unsigned int, in the byte
+ * order of the machine) followed by that many characters, the first of which is the
+ * command:
+ *
+ *		A, a new line and lines of processes, as in the processes file: the processes
+ *			enter the system at their entry times
+ *		T and a time: the simulation goes through all the seconds before the time, which
+ *			is a number of seconds from 0 on (anything else ends the connection)
+ *		E: the simulation goes on until all the processes finished, and is over
+ *
+ * and gets a message in the same form back for every message: nothing for A, and the
+ * events of the seconds that were gone through for T and E, as they are printed out by
+ * the program. Once the simulation is over, or the client goes away, the connection is
+ * closed and the next client gets a new simulation, with the options of the program.
+ *
+ * A process cannot enter in the past: if its entry time is before the time the
+ * simulation got to, or before the entry time of the process sent before it, it enters
+ * at that time.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* memcpy, strncpy */
+#include <ctype.h>      /* isspace */
+#include <errno.h>      /* errno */
+#include <limits.h>     /* INT_MAX */
+#include <unistd.h>     /* read, close, unlink */
+#include <sys/socket.h> /* socket, bind, listen, accept, send */
+#include <sys/un.h>     /* sockaddr_un */
+#include <sys/stat.h>   /* lstat */
+#include "scheduler.h"
+#define MAX_MESSAGE (64*1024*1024) //biggest message a client may send
+
+/*functions*/
+static void serve_client(int fd, simulation_t *settings);
+static int read_message(int fd, char **message, unsigned int *capacity, unsigned int *length);
+static int send_message(int fd, char *message, unsigned int length);
+static void add_processes(simulation_t *sim, char *lines, unsigned int length, int *last_entry);
+static int parse_time(char *text, int *time);
+static int advance(int fd, simulation_t *sim, int until);
+
+
+/*
+ * Function: serve
+ * -------------------
+ * creates the socket and serves the clients that connect to it, one after another, until
+ * the program is stopped. A socket left at the path by a program that was stopped before
+ * is replaced, but any other file at the path is left alone and the program stops.
+ *
+ * path: path of the socket
+ * settings: simulation the policy, the CPUs and the rest of the options are taken from
+ *
+ * returns: none
+ */
+void serve(char *path, simulation_t *settings){
+	struct sockaddr_un address;
+	struct stat file;
+	int listener;
+	int fd;
+
+	if (strlen(path)>=sizeof(address.sun_path)){
+		printf("The path of the socket is too long");
+		exit(0);
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family=AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path)-1);
+	listener=socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener==-1){
+		printf("The socket could not be open. Try again");
+		exit(0);
+	}
+	if (lstat(path, &file)==0){
+		if (!S_ISSOCK(file.st_mode)){
+			printf("The path of the socket is taken by another file");
+			exit(0);
+		}
+		unlink(path);
+	}
+	if (bind(listener, (struct sockaddr *)&address, sizeof(address))!=0 || listen(listener, 16)!=0){
+		printf("The socket could not be open. Try again");
+		exit(0);
+	}
+	while (1){
+		fd=accept(listener, NULL, NULL);
+		if (fd!=-1){
+			serve_client(fd, settings);
+			close(fd);
+		}
+	}
+}
+
+/*
+ * Function: serve_client
+ * -------------------
+ * simulates the processes the client sends, answering its messages, until the simulation
+ * is over or the client goes away. A message which is not understood ends the connection.
+ *
+ * fd: the connection
+ * settings: simulation the options are taken from
+ *
+ * returns: none
+ */
+static void serve_client(int fd, simulation_t *settings){
+	simulation_t sim;
+	trace_t trace;
+	char *message=NULL; //the last message
+	unsigned int capacity=0; //number of characters allocated for the message
+	unsigned int length;
+	int last_entry=0; //entry time of the last process that was sent
+	int over=0; //1 once the simulation is over
+	int until; //time the client asked for
+
+	init_simulation(&sim, settings->policy, settings->cpus);
+	sim.quantum=settings->quantum;
+	sim.switch_cost=settings->switch_cost;
+	sim.migration_cost=settings->migration_cost;
+	sim.levels=settings->levels;
+	memcpy(sim.level_quanta, settings->level_quanta, sizeof(sim.level_quanta));
+	sim.boost_period=settings->boost_period;
+	sim.fair_share=settings->fair_share;
+	sim.log_level=settings->log_level;
+	memset(&trace, 0, sizeof(trace_t));
+	sim.trace=&trace;
+	sim.until=0;
+
+	while (!over && read_message(fd, &message, &capacity, &length)){
+		if (message[0]=='A'){
+			add_processes(&sim, message+1, length-1, &last_entry);
+			if (!send_message(fd, NULL, 0)){
+				break;
+			}
+		}
+		else if (message[0]=='T'){
+			message[length]='\0';
+			if (!parse_time(message+1, &until) || !advance(fd, &sim, until)){
+				break;
+			}
+		}
+		else if (message[0]=='E'){
+			over=1;
+			advance(fd, &sim, -1);
+		}
+		else{
+			break;
+		}
+	}
+	/*the run queues are freed, if the simulation is not over*/
+	if (!over && sim.cpu!=NULL){
+		sim.policy->on_end(&sim);
+	}
+	free(message);
+	free_trace(&trace);
+	free_simulation(&sim);
+}
+
+/*
+ * Function: read_message
+ * -------------------
+ * reads the next message of the client, growing the space for it if it is too small.
+ * One more character is allocated after the message, so that it can be ended.
+ *
+ * fd: the connection
+ * message: the space for the message
+ * capacity: number of characters allocated for it
+ * length: length of the message
+ *
+ * returns: 1 if the message was read, 0 if the client went away or the message is empty or too long
+ */
+static int read_message(int fd, char **message, unsigned int *capacity, unsigned int *length){
+	unsigned int done=0;
+	ssize_t count;
+
+	while (done<sizeof(unsigned int)){
+		count=read(fd, (char *)length+done, sizeof(unsigned int)-done);
+		if (count<=0){
+			return 0;
+		}
+		done+=count;
+	}
+	if (*length==0 || *length>MAX_MESSAGE){
+		return 0;
+	}
+	if (*length+1>*capacity){
+		*capacity=*length+1;
+		*message=realloc(*message, *capacity);
+		if (*message==NULL){
+			printf("There is not enough memory for the processes");
+			exit(0);
+		}
+	}
+	done=0;
+	while (done<*length){
+		count=read(fd, *message+done, *length-done);
+		if (count<=0){
+			return 0;
+		}
+		done+=count;
+	}
+	return 1;
+}
+
+/*
+ * Function: send_message
+ * -------------------
+ * sends the message to the client, after its length
+ *
+ * fd: the connection
+ * message: the message
+ * length: length of the message
+ *
+ * returns: 1 if it was sent, 0 if the client went away
+ */
+static int send_message(int fd, char *message, unsigned int length){
+	unsigned int done=0;
+	ssize_t count;
+
+	if (send(fd, &length, sizeof(unsigned int), MSG_NOSIGNAL)!=sizeof(unsigned int)){
+		return 0;
+	}
+	while (done<length){
+		count=send(fd, message+done, length-done, MSG_NOSIGNAL);
+		if (count<=0){
+			return 0;
+		}
+		done+=count;
+	}
+	return 1;
+}
+
+/*
+ * Function: add_processes
+ * -------------------
+ * adds the processes in the lines to the trace of the simulation, after the ones which
+ * did not enter yet. The processes that entered are dropped from the trace first, so
+ * that it only grows with the processes waiting to enter.
+ *
+ * sim: the simulation
+ * lines: lines of processes, as in the processes file
+ * length: number of characters of the lines
+ * last_entry: entry time of the last process that was sent
+ *
+ * returns: none
+ */
+static void add_processes(simulation_t *sim, char *lines, unsigned int length, int *last_entry){
+	trace_t *trace=sim->trace;
+	FILE *fp;
+	reader_t *reader;
+	pcb_t process;
+
+	if (length==0){
+		return;
+	}
+	fp=fmemopen(lines, length, "r");
+	if (fp==NULL){
+		return;
+	}
+	if (sim->trace_position==trace->count){
+		trace->count=0;
+		trace->names_size=0;
+		sim->trace_position=0;
+	}
+	reader=open_reader(fp);
+	while (read_process(reader, &process)){
+		if (process.entryTime<sim->clock){
+			process.entryTime=sim->clock;
+		}
+		if (process.entryTime<*last_entry){
+			process.entryTime=*last_entry;
+		}
+		*last_entry=process.entryTime;
+		append_trace(trace, &process);
+	}
+	free(reader);
+	fclose(fp);
+}
+
+/*
+ * Function: parse_time
+ * -------------------
+ * reads the time of a T message: a number of seconds from 0 to INT_MAX, with blanks
+ * around it. A negative time would run the simulation to the end as E does, without
+ * the connection knowing it is over.
+ *
+ * text: the message after the command, ended by a null character
+ * time: the time read
+ *
+ * returns: 1 if the time was read, 0 if it is not a number or out of range
+ */
+static int parse_time(char *text, int *time){
+	char *end;
+	long value;
+	errno=0;
+	value=strtol(text, &end, 10);
+	if (end==text || errno!=0 || value<0 || value>INT_MAX){
+		return 0;
+	}
+	while (isspace((unsigned char)*end)){
+		end+=1;
+	}
+	if (*end!='\0'){
+		return 0;
+	}
+	*time=value;
+	return 1;
+}
+
+/*
+ * Function: advance
+ * -------------------
+ * goes on with the simulation until the time, and sends the events printed out meanwhile
+ * to the client. A time before the one the simulation got to does not go back.
+ *
+ * fd: the connection
+ * sim: the simulation
+ * until: time to stop at, -1 to go on until all the processes finished
+ *
+ * returns: 1 if the events were sent, 0 if the client went away
+ */
+static int advance(int fd, simulation_t *sim, int until){
+	char *events=NULL;
+	size_t length=0;
+	int sent;
+
+	sim->log_file=open_memstream(&events, &length);
+	if (sim->log_file==NULL){
+		out_of_memory(sim);
+	}
+	if (until<0 || until>sim->clock){
+		sim->until=until;
+		simulate(sim);
+	}
+	flush_log(sim);
+	fclose(sim->log_file);
+	sim->log_file=stdout;
+	sent=send_message(fd, events, length);
+	free(events);
+	return sent;
+}
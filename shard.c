@@ -0,0 +1,393 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Parallel simulation of a single CPU. With FCFS or SRTN the CPU is never idle while a
+ * process is in the system, so the schedule falls apart into busy periods separated by
+ * idle gaps, and a busy period does not depend on the ones before it: the system is
+ * empty when it starts, and the simulation is in the same state as when it starts at
+ * that time. The trace is therefore split into shards at idle gaps, the shards are
+ * simulated by a pool of threads at the same time, each of them printing its events
+ * and writing its results into temporary files, and then they are put together in
+ * order, so that the output is the same as if the trace was simulated in one piece.
+ *
+ * The gaps are found in a single pass over the trace, without simulating it: every
+ * process keeps the CPU busy for the switch cost and its service time (at least a
+ * second), starting once it enters or once the CPU is free, so a busy period ends
+ * once the CPU has done all the work that entered during it. With legacy timing (FCFS),
+ * the CPU also rests for a second after every completion before the next process runs.
+ * SRTN may preempt the running process at any quantum, so the number of its context
+ * switches, and the time they cost, is not known in advance; with a switch cost it is
+ * simulated in one piece. So is any other policy, more than one CPU, and the share
+ * deviation, which depends on all the processes since the start.
+ *
+ * Each shard checks that it ended where the next one was expected to start; if it did
+ * not, the rest of the trace is simulated again in one piece from where it started.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* memset, memcpy */
+#include <pthread.h>    /* threads */
+#include "scheduler.h"
+
+/* Part of the trace which starts after an idle gap and its simulation*/
+typedef struct{
+	int start; //position of its first process in the trace
+	int count; //number of its processes
+	int clock; //time at which it starts, when the busy period before it ended
+	int follows; //1 if the processes of other shards follow it
+	trace_t trace; //its processes, pointing into the columns of the whole trace
+	simulation_t sim; //its simulation, with the totals once it is over
+	cpu_t cpu; //the CPU, once the simulation is over
+	FILE *events; //temporary file its events are printed out to, NULL if none
+	FILE *results; //temporary file its results are written to, NULL if none
+} shard_t;
+
+/* Work shared by the threads of the pool*/
+typedef struct{
+	simulation_t *settings; //simulation the options are taken from
+	trace_t *trace; //the whole trace
+	shard_t *shards; //shards to be simulated
+	int count; //number of the shards
+	int next; //the next shard to be taken by a thread
+	pthread_mutex_t lock; //protects the next shard
+} pool_t;
+
+/*functions*/
+static int can_shard(simulation_t *sim);
+static int find_shards(simulation_t *sim, trace_t *trace, int target, shard_t **shards);
+static void *work(void *argument);
+static void run_shard(simulation_t *settings, trace_t *trace, shard_t *shard);
+static void close_shard(shard_t *shard);
+static void add_shard(simulation_t *sim, shard_t *shard);
+static void copy_file(FILE *from, FILE *to);
+
+
+/*
+ * Function: simulate_shards
+ * -------------------
+ * simulates the trace of the simulation with the given number of threads, a shard of it
+ * at a time each, if it can be split at idle gaps (see can_shard()); otherwise simulates
+ * it in one piece. The events are printed out, the results written and the totals kept
+ * just as by simulate().
+ *
+ * sim: the simulation, with its trace
+ * jobs: number of threads
+ *
+ * returns: none
+ */
+void simulate_shards(simulation_t *sim, int jobs){
+	pool_t pool;
+	pthread_t *threads;
+	int target; //number of processes a shard is to have at least
+	int look_up;
+	int rest;
+
+	if (!can_shard(sim)){
+		simulate(sim);
+		return;
+	}
+	target=sim->trace->count/(jobs*SHARDS_PER_JOB);
+	if (target<MIN_SHARD_SIZE){
+		target=MIN_SHARD_SIZE;
+	}
+	pool.count=find_shards(sim, sim->trace, target, &pool.shards);
+	/*a trace without idle gaps is simulated as usual*/
+	if (pool.count==1){
+		free(pool.shards);
+		simulate(sim);
+		return;
+	}
+	pool.settings=sim;
+	pool.trace=sim->trace;
+	pool.next=0;
+	threads=malloc(sizeof(pthread_t)*jobs);
+	if (threads==NULL){
+		out_of_memory(sim);
+	}
+
+	/*the threads take the shards one by one until there are none left*/
+	pthread_mutex_init(&pool.lock, NULL);
+	if (jobs>pool.count){
+		jobs=pool.count;
+	}
+	for (look_up=0; look_up<jobs; look_up++){
+		if (pthread_create(&threads[look_up], NULL, work, &pool)!=0){
+			printf("The threads could not be started");
+			exit(0);
+		}
+	}
+	for (look_up=0; look_up<jobs; look_up++){
+		pthread_join(threads[look_up], NULL);
+	}
+	pthread_mutex_destroy(&pool.lock);
+
+	/*the simulation of the whole trace gets the CPU the totals of the shards are added to*/
+	sim->cpu=calloc(1, sizeof(cpu_t));
+	if (sim->cpu==NULL){
+		out_of_memory(sim);
+	}
+	sim->cpu[0].process_to_run=-1;
+	for (look_up=0; look_up<pool.count; look_up++){
+		/*a shard which did not end where the next one starts is simulated again with the rest of the trace*/
+		if (look_up+1<pool.count && pool.shards[look_up].sim.end_time!=pool.shards[look_up+1].clock){
+			for (rest=look_up; rest<pool.count; rest++){
+				close_shard(&pool.shards[rest]);
+			}
+			pool.shards[look_up].count=sim->trace->count-pool.shards[look_up].start;
+			pool.shards[look_up].follows=0;
+			run_shard(sim, sim->trace, &pool.shards[look_up]);
+			pool.count=look_up+1;
+		}
+		add_shard(sim, &pool.shards[look_up]);
+		close_shard(&pool.shards[look_up]);
+	}
+	free(pool.shards);
+	free(threads);
+}
+
+/*
+ * Function: can_shard
+ * -------------------
+ * Checks whether the simulation falls apart into independent busy periods, which are
+ * found in advance: a single CPU, FCFS or SRTN (without a switch cost), no checkpoints
+ * and no share deviation, with the processes in a trace
+ *
+ * sim: the simulation
+ *
+ * returns: 1 if the trace can be split, 0 otherwise
+ */
+static int can_shard(simulation_t *sim){
+	if (sim->trace==NULL || sim->cpus!=1 || sim->fair_share || sim->checkpoint!=NULL || sim->resumed){
+		return 0;
+	}
+	if (sim->policy==&srtn_policy){
+		return sim->switch_cost==0;
+	}
+	return sim->policy==&fcfs_policy;
+}
+
+/*
+ * Function: find_shards
+ * -------------------
+ * splits the trace into shards of at least the given number of processes (apart from
+ * the last one), each starting at the first idle gap after that many. The end of every
+ * busy period is found by going through the processes in order (see the top of the file).
+ *
+ * sim: the simulation
+ * trace: the trace
+ * target: number of processes a shard is to have at least
+ * shards: set to the shards, allocated
+ *
+ * returns: number of the shards
+ */
+static int find_shards(simulation_t *sim, trace_t *trace, int target, shard_t **shards){
+	int legacy=sim->policy->legacy_timing; //second the CPU rests after a completion
+	long long end=0; //time at which the CPU has done all the work so far
+	long long begin; //time at which the process starts to keep the CPU busy
+	int capacity=INITIAL_CAPACITY;
+	int count=1;
+	int look_up;
+	int entry;
+	int service;
+
+	*shards=calloc(capacity, sizeof(shard_t));
+	if (*shards==NULL){
+		out_of_memory(sim);
+	}
+	for (look_up=0; look_up<trace->count; look_up++){
+		entry=trace->entryTime[look_up];
+		service=trace->serviceTime[look_up];
+		/*the CPU is idle when the process enters, so a shard may start with it*/
+		if (entry>end && look_up-(*shards)[count-1].start>=target){
+			if (count==capacity){
+				capacity*=2;
+				*shards=realloc(*shards, sizeof(shard_t)*capacity);
+				if (*shards==NULL){
+					out_of_memory(sim);
+				}
+			}
+			memset(&(*shards)[count], 0, sizeof(shard_t));
+			(*shards)[count].start=look_up;
+			(*shards)[count].clock=(int)end;
+			count+=1;
+		}
+		if (look_up==0){
+			begin=entry>0 ? entry : 0;
+		}
+		else if (entry>end){
+			begin=entry;
+		}
+		else{
+			begin=end+legacy;
+		}
+		end=begin+sim->switch_cost+(service>1 ? service : 1);
+	}
+	for (look_up=0; look_up<count; look_up++){
+		if (look_up+1<count){
+			(*shards)[look_up].count=(*shards)[look_up+1].start-(*shards)[look_up].start;
+			(*shards)[look_up].follows=1;
+		}
+		else{
+			(*shards)[look_up].count=trace->count-(*shards)[look_up].start;
+		}
+	}
+	return count;
+}
+
+/*
+ * Function: work
+ * -------------------
+ * keeps simulating the next shard of the pool, until there are none left
+ *
+ * argument: the pool
+ *
+ * returns: NULL
+ */
+static void *work(void *argument){
+	pool_t *pool=argument;
+	int index;
+	while (1){
+		pthread_mutex_lock(&pool->lock);
+		index=pool->next;
+		pool->next+=1;
+		pthread_mutex_unlock(&pool->lock);
+		if (index>=pool->count){
+			return NULL;
+		}
+		run_shard(pool->settings, pool->trace, &pool->shards[index]);
+	}
+}
+
+/*
+ * Function: run_shard
+ * -------------------
+ * simulates the processes of the shard from the time it starts at, with the options of
+ * the simulation of the whole trace, printing out the events and writing the results
+ * into temporary files if they are printed out and written at all
+ *
+ * settings: simulation the options are taken from
+ * trace: the whole trace
+ * shard: the shard
+ *
+ * returns: none
+ */
+static void run_shard(simulation_t *settings, trace_t *trace, shard_t *shard){
+	simulation_t *sim=&shard->sim;
+	int start=shard->start;
+
+	/*the trace of the shard is a part of the columns of the whole trace*/
+	memset(&shard->trace, 0, sizeof(trace_t));
+	shard->trace.count=shard->count;
+	shard->trace.entryTime=trace->entryTime+start;
+	shard->trace.serviceTime=trace->serviceTime+start;
+	shard->trace.deadline=trace->deadline+start;
+	shard->trace.tickets=trace->tickets!=NULL ? trace->tickets+start : NULL;
+	shard->trace.name_offsets=trace->name_offsets+start;
+	shard->trace.names=trace->names;
+	shard->trace.names_size=trace->names_size;
+
+	init_simulation(sim, settings->policy, 1);
+	sim->quantum=settings->quantum;
+	sim->switch_cost=settings->switch_cost;
+	sim->migration_cost=settings->migration_cost;
+	sim->format=settings->format;
+	sim->log_level=settings->log_level;
+	sim->trace=&shard->trace;
+	sim->clock=shard->clock;
+	sim->follows=shard->follows;
+	shard->events=NULL;
+	shard->results=NULL;
+	if (sim->log_level!=LOG_OFF){
+		shard->events=tmpfile();
+		sim->log_file=shard->events;
+	}
+	if (settings->results!=NULL){
+		shard->results=tmpfile();
+		sim->results=shard->results;
+	}
+	if ((sim->log_level!=LOG_OFF && shard->events==NULL) || (settings->results!=NULL && shard->results==NULL)){
+		printf("The temporary files could not be open. Try again");
+		exit(0);
+	}
+	simulate(sim);
+	flush_log(sim);
+	shard->cpu=sim->cpu[0];
+	free_simulation(sim);
+}
+
+/*
+ * Function: close_shard
+ * -------------------
+ * closes the temporary files of the shard, which removes them
+ *
+ * shard: the shard
+ *
+ * returns: none
+ */
+static void close_shard(shard_t *shard){
+	if (shard->events!=NULL){
+		fclose(shard->events);
+		shard->events=NULL;
+	}
+	if (shard->results!=NULL){
+		fclose(shard->results);
+		shard->results=NULL;
+	}
+}
+
+/*
+ * Function: add_shard
+ * -------------------
+ * prints out the events of the shard and writes its results after the ones of the
+ * shards before it, and adds its totals to the simulation of the whole trace
+ *
+ * sim: simulation of the whole trace
+ * shard: the shard
+ *
+ * returns: none
+ */
+static void add_shard(simulation_t *sim, shard_t *shard){
+	cpu_t *cpu=&sim->cpu[0];
+	if (shard->events!=NULL){
+		copy_file(shard->events, sim->log_file);
+	}
+	if (shard->results!=NULL){
+		copy_file(shard->results, sim->results);
+	}
+	sim->finished+=shard->sim.finished;
+	sim->total_wait+=shard->sim.total_wait;
+	sim->total_turnaround+=shard->sim.total_turnaround;
+	sim->deadlines_met+=shard->sim.deadlines_met;
+	sim->end_time=shard->sim.end_time;
+	sketch_merge(&sim->wait_times, &shard->sim.wait_times);
+	sketch_merge(&sim->turnaround_times, &shard->sim.turnaround_times);
+	cpu->busy_time+=shard->cpu.busy_time;
+	cpu->migrations+=shard->cpu.migrations;
+	cpu->switches+=shard->cpu.switches;
+	cpu->lost_time+=shard->cpu.lost_time;
+}
+
+/*
+ * Function: copy_file
+ * -------------------
+ * copies everything written into the temporary file to the end of the other one
+ *
+ * from: the temporary file
+ * to: file to be copied to
+ *
+ * returns: none
+ */
+static void copy_file(FILE *from, FILE *to){
+	char buffer[BUFFER_SIZE];
+	size_t size;
+	rewind(from);
+	while ((size=fread(buffer, 1, BUFFER_SIZE, from))>0){
+		fwrite(buffer, 1, size, to);
+	}
+	if (ferror(from)){
+		printf("The temporary files could not be read. Try again");
+		exit(0);
+	}
+}
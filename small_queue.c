@@ -0,0 +1,346 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Run queue for a few processes (small_queue_t), used by the preemptive policies
+ * instead of their heaps while only a few processes are waiting. The processes are
+ * kept in arrays in order of arrival, with what they are compared by copied next to
+ * each other, so the process to run next is found by going through the arrays at once
+ * (see find_first_min()). For few processes it is faster than keeping a heap in order,
+ * and the search is done with AVX2 or SSE4.1 instructions when the CPU has them.
+ */
+
+#include <stdlib.h>     /* realloc */
+#include <string.h>     /* memmove */
+#include <limits.h>     /* INT_MAX */
+#include "scheduler.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTORIZED 1
+#include <immintrin.h>  /* AVX2 and SSE4.1 */
+#endif
+
+/*functions*/
+static int find_first_min_scalar(const int *keys, const int *ties, const int *limits, int time, int count);
+#ifdef VECTORIZED
+static int find_first_min_avx2(const int *keys, const int *ties, const int *limits, int time, int count);
+static int find_first_min_sse4(const int *keys, const int *ties, const int *limits, int time, int count);
+#endif
+
+
+/*
+ * Function: small_insert
+ * -------------------
+ * inserts the process into the run queue, keeping the order of arrival. The new
+ * processes arrive last, so only the processes given back by the CPU are moved in
+ * between the others.
+ *
+ * sim: the simulation
+ * small: the run queue
+ * place: place of the process in the queue of the simulation
+ * key: what the process is compared by, smaller first
+ * tie: what the process is compared by if the keys are the same
+ * limit: latest time at which the process may still be chosen
+ *
+ * returns: none
+ */
+void small_insert(simulation_t *sim, small_queue_t *small, int place, int key, int tie, int limit){
+	int *arrival=sim->queue.arrival;
+	int position=small->size;
+	int moved;
+	if (small->size==small->capacity){
+		small->capacity=small->capacity==0 ? SMALL_QUEUE_SIZE : small->capacity*2;
+		small->places=realloc(small->places, sizeof(int)*small->capacity);
+		small->keys=realloc(small->keys, sizeof(int)*small->capacity);
+		small->ties=realloc(small->ties, sizeof(int)*small->capacity);
+		small->limits=realloc(small->limits, sizeof(int)*small->capacity);
+		if (small->places==NULL || small->keys==NULL || small->ties==NULL || small->limits==NULL){
+			out_of_memory(sim);
+		}
+	}
+	while (position>0 && arrival[small->places[position-1]]>arrival[place]){
+		position-=1;
+	}
+	moved=small->size-position;
+	if (moved>0){
+		memmove(small->places+position+1, small->places+position, sizeof(int)*moved);
+		memmove(small->keys+position+1, small->keys+position, sizeof(int)*moved);
+		memmove(small->ties+position+1, small->ties+position, sizeof(int)*moved);
+		memmove(small->limits+position+1, small->limits+position, sizeof(int)*moved);
+	}
+	small->places[position]=place;
+	small->keys[position]=key;
+	small->ties[position]=tie;
+	small->limits[position]=limit;
+	small->size+=1;
+}
+
+/*
+ * Function: small_remove
+ * -------------------
+ * removes the process at the position from the run queue, keeping the order of the others
+ *
+ * small: the run queue
+ * position: position of the process in the run queue
+ *
+ * returns: place of the process in the queue of the simulation
+ */
+int small_remove(small_queue_t *small, int position){
+	int place=small->places[position];
+	int moved=small->size-position-1;
+	if (moved>0){
+		memmove(small->places+position, small->places+position+1, sizeof(int)*moved);
+		memmove(small->keys+position, small->keys+position+1, sizeof(int)*moved);
+		memmove(small->ties+position, small->ties+position+1, sizeof(int)*moved);
+		memmove(small->limits+position, small->limits+position+1, sizeof(int)*moved);
+	}
+	small->size-=1;
+	return place;
+}
+
+/*
+ * Function: small_free
+ * -------------------
+ * frees the arrays of the run queue
+ *
+ * small: the run queue
+ *
+ * returns: none
+ */
+void small_free(small_queue_t *small){
+	free(small->places);
+	free(small->keys);
+	free(small->ties);
+	free(small->limits);
+}
+
+/*
+ * Function: find_first_min
+ * -------------------
+ * Finds the first position with the smallest key, of the positions whose limit is not
+ * below the time. If several have the smallest key, the one with the smallest tie is
+ * chosen, and if the ties are the same too, the first of them. Uses AVX2 or SSE4.1
+ * if the CPU has them.
+ *
+ * keys: what the positions are compared by
+ * ties: what the positions are compared by if the keys are the same, NULL if not used
+ * limits: latest time at which each position may be chosen, NULL if not used
+ * time: current time
+ * count: number of positions
+ *
+ * returns: the position, -1 if there is none
+ */
+int find_first_min(const int *keys, const int *ties, const int *limits, int time, int count){
+#ifdef VECTORIZED
+	if (__builtin_cpu_supports("avx2")){
+		return find_first_min_avx2(keys, ties, limits, time, count);
+	}
+	if (__builtin_cpu_supports("sse4.1")){
+		return find_first_min_sse4(keys, ties, limits, time, count);
+	}
+#endif
+	return find_first_min_scalar(keys, ties, limits, time, count);
+}
+
+/*
+ * Function: find_first_min_scalar
+ * -------------------
+ * find_first_min() one position at a time, for the CPUs without the vector instructions
+ *
+ * returns: the position, -1 if there is none
+ */
+static int find_first_min_scalar(const int *keys, const int *ties, const int *limits, int time, int count){
+	int best=-1;
+	int look_up;
+	for (look_up=0; look_up<count; look_up++){
+		if (limits!=NULL && limits[look_up]<time){
+			continue;
+		}
+		if (best==-1 || keys[look_up]<keys[best] || (ties!=NULL && keys[look_up]==keys[best] && ties[look_up]<ties[best])){
+			best=look_up;
+		}
+	}
+	return best;
+}
+
+#ifdef VECTORIZED
+/*
+ * Function: find_first_min_avx2
+ * -------------------
+ * find_first_min() 8 positions at a time: the smallest key of the positions within
+ * their limit is found first, then the smallest tie of the positions with that key,
+ * and then the first position with both.
+ *
+ * returns: the position, -1 if there is none
+ */
+__attribute__((target("avx2")))
+static int find_first_min_avx2(const int *keys, const int *ties, const int *limits, int time, int count){
+	__m256i now=_mm256_set1_epi32(time);
+	__m256i none=_mm256_set1_epi32(INT_MAX);
+	__m256i smallest=none;
+	__m256i values;
+	__m256i late; //all ones in the lanes which are over their limit
+	__m256i chosen;
+	int lanes[8];
+	int min_key=INT_MAX;
+	int min_tie=INT_MAX;
+	int look_up;
+	int mask;
+	int end=count-count%8;
+
+	/*the smallest key*/
+	for (look_up=0; look_up<end; look_up+=8){
+		values=_mm256_loadu_si256((const __m256i *)(keys+look_up));
+		if (limits!=NULL){
+			late=_mm256_cmpgt_epi32(now, _mm256_loadu_si256((const __m256i *)(limits+look_up)));
+			values=_mm256_blendv_epi8(values, none, late);
+		}
+		smallest=_mm256_min_epi32(smallest, values);
+	}
+	_mm256_storeu_si256((__m256i *)lanes, smallest);
+	for (look_up=0; look_up<8; look_up++){
+		if (lanes[look_up]<min_key){
+			min_key=lanes[look_up];
+		}
+	}
+	for (look_up=end; look_up<count; look_up++){
+		if ((limits==NULL || limits[look_up]>=time) && keys[look_up]<min_key){
+			min_key=keys[look_up];
+		}
+	}
+
+	/*the smallest tie of the positions with the smallest key*/
+	if (ties!=NULL){
+		smallest=none;
+		for (look_up=0; look_up<end; look_up+=8){
+			chosen=_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(keys+look_up)), _mm256_set1_epi32(min_key));
+			if (limits!=NULL){
+				chosen=_mm256_andnot_si256(_mm256_cmpgt_epi32(now, _mm256_loadu_si256((const __m256i *)(limits+look_up))), chosen);
+			}
+			values=_mm256_blendv_epi8(none, _mm256_loadu_si256((const __m256i *)(ties+look_up)), chosen);
+			smallest=_mm256_min_epi32(smallest, values);
+		}
+		_mm256_storeu_si256((__m256i *)lanes, smallest);
+		for (look_up=0; look_up<8; look_up++){
+			if (lanes[look_up]<min_tie){
+				min_tie=lanes[look_up];
+			}
+		}
+		for (look_up=end; look_up<count; look_up++){
+			if ((limits==NULL || limits[look_up]>=time) && keys[look_up]==min_key && ties[look_up]<min_tie){
+				min_tie=ties[look_up];
+			}
+		}
+	}
+
+	/*the first position with both*/
+	for (look_up=0; look_up<end; look_up+=8){
+		chosen=_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(keys+look_up)), _mm256_set1_epi32(min_key));
+		if (ties!=NULL){
+			chosen=_mm256_and_si256(chosen, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(ties+look_up)), _mm256_set1_epi32(min_tie)));
+		}
+		if (limits!=NULL){
+			chosen=_mm256_andnot_si256(_mm256_cmpgt_epi32(now, _mm256_loadu_si256((const __m256i *)(limits+look_up))), chosen);
+		}
+		mask=_mm256_movemask_ps(_mm256_castsi256_ps(chosen));
+		if (mask!=0){
+			return look_up+__builtin_ctz(mask);
+		}
+	}
+	for (look_up=end; look_up<count; look_up++){
+		if ((limits==NULL || limits[look_up]>=time) && keys[look_up]==min_key && (ties==NULL || ties[look_up]==min_tie)){
+			return look_up;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Function: find_first_min_sse4
+ * -------------------
+ * find_first_min_avx2() 4 positions at a time, for the CPUs without AVX2
+ *
+ * returns: the position, -1 if there is none
+ */
+__attribute__((target("sse4.1")))
+static int find_first_min_sse4(const int *keys, const int *ties, const int *limits, int time, int count){
+	__m128i now=_mm_set1_epi32(time);
+	__m128i none=_mm_set1_epi32(INT_MAX);
+	__m128i smallest=none;
+	__m128i values;
+	__m128i late; //all ones in the lanes which are over their limit
+	__m128i chosen;
+	int lanes[4];
+	int min_key=INT_MAX;
+	int min_tie=INT_MAX;
+	int look_up;
+	int mask;
+	int end=count-count%4;
+
+	/*the smallest key*/
+	for (look_up=0; look_up<end; look_up+=4){
+		values=_mm_loadu_si128((const __m128i *)(keys+look_up));
+		if (limits!=NULL){
+			late=_mm_cmpgt_epi32(now, _mm_loadu_si128((const __m128i *)(limits+look_up)));
+			values=_mm_blendv_epi8(values, none, late);
+		}
+		smallest=_mm_min_epi32(smallest, values);
+	}
+	_mm_storeu_si128((__m128i *)lanes, smallest);
+	for (look_up=0; look_up<4; look_up++){
+		if (lanes[look_up]<min_key){
+			min_key=lanes[look_up];
+		}
+	}
+	for (look_up=end; look_up<count; look_up++){
+		if ((limits==NULL || limits[look_up]>=time) && keys[look_up]<min_key){
+			min_key=keys[look_up];
+		}
+	}
+
+	/*the smallest tie of the positions with the smallest key*/
+	if (ties!=NULL){
+		smallest=none;
+		for (look_up=0; look_up<end; look_up+=4){
+			chosen=_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(keys+look_up)), _mm_set1_epi32(min_key));
+			if (limits!=NULL){
+				chosen=_mm_andnot_si128(_mm_cmpgt_epi32(now, _mm_loadu_si128((const __m128i *)(limits+look_up))), chosen);
+			}
+			values=_mm_blendv_epi8(none, _mm_loadu_si128((const __m128i *)(ties+look_up)), chosen);
+			smallest=_mm_min_epi32(smallest, values);
+		}
+		_mm_storeu_si128((__m128i *)lanes, smallest);
+		for (look_up=0; look_up<4; look_up++){
+			if (lanes[look_up]<min_tie){
+				min_tie=lanes[look_up];
+			}
+		}
+		for (look_up=end; look_up<count; look_up++){
+			if ((limits==NULL || limits[look_up]>=time) && keys[look_up]==min_key && ties[look_up]<min_tie){
+				min_tie=ties[look_up];
+			}
+		}
+	}
+
+	/*the first position with both*/
+	for (look_up=0; look_up<end; look_up+=4){
+		chosen=_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(keys+look_up)), _mm_set1_epi32(min_key));
+		if (ties!=NULL){
+			chosen=_mm_and_si128(chosen, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(ties+look_up)), _mm_set1_epi32(min_tie)));
+		}
+		if (limits!=NULL){
+			chosen=_mm_andnot_si128(_mm_cmpgt_epi32(now, _mm_loadu_si128((const __m128i *)(limits+look_up))), chosen);
+		}
+		mask=_mm_movemask_ps(_mm_castsi128_ps(chosen));
+		if (mask!=0){
+			return look_up+__builtin_ctz(mask);
+		}
+	}
+	for (look_up=end; look_up<count; look_up++){
+		if ((limits==NULL || limits[look_up]>=time) && keys[look_up]==min_key && (ties==NULL || ties[look_up]==min_tie)){
+			return look_up;
+		}
+	}
+	return -1;
+}
+#endif
@@ -0,0 +1,603 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Sorting of the processes by entry time, for files which are not in order of it (e.g.
+ * merged from several machines). The simulation takes the processes one by one in order
+ * of the file, so a process which comes after a later one would enter too late. The
+ * processes are therefore sorted into a trace first (see sort_trace()), by entry time
+ * and, if the entry times are the same, in order of the file, and simulated from it.
+ *
+ * The sort never takes more than the given memory:
+ *		- the processes are read in chunks of as many as fit in it, and every chunk is
+ *		  sorted by a radix sort of the entry times (stable, so the order of the file is
+ *		  kept for the same entry times)
+ *		- if all of them fit in a single chunk, the trace is made straight from it
+ *		- otherwise every sorted chunk is written into a temporary file (a run), and as
+ *		  soon as enough runs of the same level to be merged at once are written, they are
+ *		  merged into one of the next level, so that only a few runs are ever kept whatever
+ *		  the size of the file. The runs left are merged the same number at a time (at
+ *		  most MERGE_WAYS, fewer if the memory does not have room for a buffer of at least
+ *		  MIN_RUN_BUFFER bytes for each of them), until a single merge
+ *		  writes the binary trace file (see trace.c), which is then mapped into memory. A
+ *		  process of an earlier run goes first if the entry times are the same, so the
+ *		  order of the file is kept.
+ * A run has no buffer while it waits to be merged, only while it is written or read, and
+ * the buffers are part of the memory, as well as the one the file is read through.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* memset, memcpy */
+#include <unistd.h>     /* close, unlink, dup, lseek */
+#include "scheduler.h"
+#define RADIX_BITS 8 //bits of the entry time sorted by in each pass of the radix sort
+#define RADIX_SIZE (1<<RADIX_BITS) //number of values of these bits
+
+/* Chunk of the processes being sorted*/
+typedef struct{
+	pcb_t *processes; //the processes, in order of the file
+	unsigned int *keys[2]; //keys of the processes, and as many the radix sort sorts into
+	int *order[2]; //positions of the processes in the sorted order, and as many the radix sort sorts into
+} chunk_t;
+
+/* Runs of the sort being merged*/
+typedef struct{
+	FILE **files; //streams the runs are read through
+	pcb_t *heads; //next process of every run
+	int *heap; //runs which have processes left, by the entry time of their next process
+	int size; //number of runs in the heap
+} merge_t;
+
+/*functions*/
+static int next_input(reader_t *reader, trace_t *input, int *position, pcb_t *process);
+static void open_chunk(chunk_t *chunk, int capacity);
+static void close_chunk(chunk_t *chunk);
+static void radix_sort(unsigned int *keys, int *order, unsigned int *spare_keys, int *spare_order, int count);
+static int create_run(void);
+static FILE *open_run(int run, char *mode, char *buffer, long buffer_size);
+static int close_run(FILE *file);
+static int write_run(chunk_t *chunk, int count, char *buffer, long buffer_size);
+static int merge_group(int *runs, int count, char *buffer, long buffer_size);
+static void merge_runs(int *runs, int count, FILE *output, trace_writer_t *writer, long buffer_size);
+static int is_before_head(merge_t *merge, int first, int second);
+static void sift_head(merge_t *merge, int position);
+static void *allocate(size_t size);
+
+
+/*
+ * Function: sort_trace
+ * -------------------
+ * sorts the processes by entry time into the trace. They are read from the file or, if
+ * there is none, taken from the trace itself (mapped from a binary trace file), which is
+ * then replaced by the sorted one. A trace which is in order already is kept as it is.
+ *
+ * fp: file to be read from, NULL if the processes are in the trace
+ * trace: the trace the processes are sorted into
+ * memory: number of bytes the processes are sorted in
+ *
+ * returns: none
+ */
+void sort_trace(FILE *fp, trace_t *trace, long memory){
+	trace_t input; //processes of the trace, if they are not read from the file
+	reader_t *reader=NULL;
+	int position=0; //position of the next process in the input trace
+	int capacity; //number of processes in a chunk
+	chunk_t chunk;
+	int size; //number of processes in the chunk
+	int *runs=NULL; //descriptors of the runs, in order of the file
+	int *levels=NULL; //number of merges each run went through, never growing along the runs
+	int run_count=0;
+	int runs_capacity=0;
+	int count=0; //number of all the processes
+	unsigned int names_size=0; //number of characters of all their names
+	int ways; //number of runs merged at once
+	long buffer_size; //size of the buffer of a run being written or read
+	char *buffer; //buffer the runs are written through
+	trace_writer_t writer;
+	char path[4096];
+	char *directory=getenv("TMPDIR");
+	int fd;
+	int look_up;
+	int merged;
+
+	if (fp==NULL){
+		for (look_up=1; look_up<trace->count && trace->entryTime[look_up-1]<=trace->entryTime[look_up]; look_up++);
+		if (look_up>=trace->count){
+			return;
+		}
+		input=*trace;
+	}
+	else{
+		reader=open_reader(fp);
+	}
+	/*the last merge reads every run through a buffer and writes the six columns of the
+	trace file through one each, all of them in the memory*/
+	ways=MERGE_WAYS;
+	if (memory/(ways+6)<MIN_RUN_BUFFER){
+		ways=memory/MIN_RUN_BUFFER-6;
+		if (ways<2){
+			ways=2;
+		}
+	}
+	buffer_size=memory/(ways+6);
+	if (buffer_size<MIN_RUN_BUFFER){
+		buffer_size=MIN_RUN_BUFFER;
+	}
+	buffer=allocate(buffer_size);
+	/*every process of the chunk takes its record and its place in the order, and either two
+	keys and a spare place while the chunk is sorted or, if all the processes fit in the
+	chunk, its columns and its name in the trace, which is more. The chunk shares the
+	memory with the buffers the file is read and a run is written through.*/
+	capacity=(memory-buffer_size-(long)sizeof(reader_t))/(long)(sizeof(pcb_t)+sizeof(int)+4*sizeof(int)+sizeof(unsigned int)+NAME_SIZE);
+	if (capacity<INITIAL_CAPACITY){
+		capacity=INITIAL_CAPACITY;
+	}
+	open_chunk(&chunk, capacity);
+
+	/*the chunks are sorted one by one*/
+	while (1){
+		size=0;
+		while (size<capacity && next_input(reader, fp==NULL ? &input : NULL, &position, &chunk.processes[size])){
+			/*the sign bit is flipped, so that the negative times go first*/
+			chunk.keys[0][size]=(unsigned int)chunk.processes[size].entryTime^0x80000000u;
+			chunk.order[0][size]=size;
+			names_size+=strlen(chunk.processes[size].processname);
+			size+=1;
+		}
+		count+=size;
+		radix_sort(chunk.keys[0], chunk.order[0], chunk.keys[1], chunk.order[1], size);
+		/*all the processes fit in memory: the trace takes the place of the keys, and is
+		allocated at its size at once*/
+		if (size<capacity && run_count==0){
+			free(chunk.keys[0]);
+			free(chunk.keys[1]);
+			free(chunk.order[1]);
+			chunk.keys[0]=NULL;
+			chunk.keys[1]=NULL;
+			chunk.order[1]=NULL;
+			memset(trace, 0, sizeof(trace_t));
+			trace->capacity=size;
+			trace->entryTime=allocate(sizeof(int)*size);
+			trace->serviceTime=allocate(sizeof(int)*size);
+			trace->deadline=allocate(sizeof(int)*size);
+			trace->tickets=allocate(sizeof(int)*size);
+			trace->name_offsets=allocate(sizeof(unsigned int)*(size+1));
+			trace->name_offsets[0]=0; //an empty file still has the offset of the first name
+			trace->names_capacity=names_size;
+			trace->names=allocate(names_size);
+			for (look_up=0; look_up<size; look_up++){
+				append_trace(trace, &chunk.processes[chunk.order[0][look_up]]);
+			}
+			break;
+		}
+		if (size==0){
+			break;
+		}
+		if (run_count==runs_capacity){
+			runs_capacity=runs_capacity==0 ? ways : runs_capacity*2;
+			runs=realloc(runs, sizeof(int)*runs_capacity);
+			levels=realloc(levels, sizeof(int)*runs_capacity);
+			if (runs==NULL || levels==NULL){
+				printf("There is not enough memory for the processes");
+				exit(0);
+			}
+		}
+		runs[run_count]=write_run(&chunk, size, buffer, buffer_size);
+		levels[run_count]=0;
+		run_count+=1;
+		if (size<capacity){
+			break;
+		}
+		/*the last ways runs of the same level become one of the next level; the chunk is
+		given up meanwhile, so that the merge has its memory*/
+		if (run_count>=ways && levels[run_count-ways]==levels[run_count-1]){
+			close_chunk(&chunk);
+			while (run_count>=ways && levels[run_count-ways]==levels[run_count-1]){
+				run_count-=ways;
+				runs[run_count]=merge_group(runs+run_count, ways, buffer, buffer_size);
+				levels[run_count]+=1;
+				run_count+=1;
+			}
+			open_chunk(&chunk, capacity);
+		}
+	}
+	close_chunk(&chunk);
+	free(reader);
+	if (fp==NULL){
+		free_trace(&input);
+	}
+	free(levels);
+	if (run_count==0){
+		free(buffer);
+		return;
+	}
+
+	/*the runs are merged ways at a time, each group of them into one run in its place, so that they stay in order of the file*/
+	while (run_count>ways){
+		merged=0;
+		for (look_up=0; look_up<run_count; look_up+=ways){
+			size=run_count-look_up<ways ? run_count-look_up : ways;
+			runs[merged]=size==1 ? runs[look_up] : merge_group(runs+look_up, size, buffer, buffer_size);
+			merged+=1;
+		}
+		run_count=merged;
+	}
+
+	/*the last merge writes the binary trace file, which is only kept until it is mapped*/
+	snprintf(path, sizeof(path), "%s/scheduler-sort-XXXXXX", directory!=NULL && directory[0]!='\0' ? directory : "/tmp");
+	fd=mkstemp(path);
+	if (fd==-1){
+		printf("The processes could not be sorted. Try again");
+		exit(0);
+	}
+	close(fd);
+	free(buffer);
+	open_trace_writer(&writer, path, count, names_size, buffer_size);
+	merge_runs(runs, run_count, NULL, &writer, buffer_size);
+	close_trace_writer(&writer);
+	free(runs);
+	memset(trace, 0, sizeof(trace_t));
+	if (!map_trace(path, trace)){
+		printf("The processes could not be sorted. Try again");
+		exit(0);
+	}
+	unlink(path);
+}
+
+/*
+ * Function: next_input
+ * -------------------
+ * gets the next process to be sorted, either from the file or from the trace
+ *
+ * reader: reader of the file, NULL if the processes are in the trace
+ * input: the trace, NULL if the processes are read from the file
+ * position: position of the next process in the trace
+ * process: process to be read into
+ *
+ * returns: 1 if there was a process, 0 at the end
+ */
+static int next_input(reader_t *reader, trace_t *input, int *position, pcb_t *process){
+	if (reader!=NULL){
+		return read_process(reader, process);
+	}
+	if (*position<input->count){
+		trace_process(input, *position, process);
+		*position+=1;
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * Function: open_chunk
+ * -------------------
+ * allocates the processes, the keys and the orders of the chunk
+ *
+ * chunk: the chunk
+ * capacity: number of processes in the chunk
+ *
+ * returns: none
+ */
+static void open_chunk(chunk_t *chunk, int capacity){
+	chunk->processes=allocate(sizeof(pcb_t)*capacity);
+	chunk->keys[0]=allocate(sizeof(unsigned int)*capacity);
+	chunk->keys[1]=allocate(sizeof(unsigned int)*capacity);
+	chunk->order[0]=allocate(sizeof(int)*capacity);
+	chunk->order[1]=allocate(sizeof(int)*capacity);
+}
+
+/*
+ * Function: close_chunk
+ * -------------------
+ * frees what open_chunk() allocated
+ *
+ * chunk: the chunk
+ *
+ * returns: none
+ */
+static void close_chunk(chunk_t *chunk){
+	free(chunk->processes);
+	free(chunk->keys[0]);
+	free(chunk->keys[1]);
+	free(chunk->order[0]);
+	free(chunk->order[1]);
+}
+
+/*
+ * Function: radix_sort
+ * -------------------
+ * sorts the order by the keys, least significant RADIX_BITS first. Each pass is stable,
+ * so the positions with the same key stay in the order they were, and a pass in which
+ * all the keys have the same bits is skipped. The keys are sorted along with the order.
+ *
+ * keys: keys of the positions
+ * order: the positions, in the order they are to be sorted from
+ * spare_keys: as many keys, which the passes sort into
+ * spare_order: as many positions, which the passes sort into
+ * count: number of the positions
+ *
+ * returns: none
+ */
+static void radix_sort(unsigned int *keys, int *order, unsigned int *spare_keys, int *spare_order, int count){
+	unsigned int *from_keys=keys;
+	int *from_order=order;
+	unsigned int *swap_keys;
+	int *swap_order;
+	int counts[RADIX_SIZE];
+	int shift;
+	int digit;
+	int sum;
+	int look_up;
+
+	for (shift=0; shift<32; shift+=RADIX_BITS){
+		memset(counts, 0, sizeof(counts));
+		for (look_up=0; look_up<count; look_up++){
+			counts[(from_keys[look_up]>>shift)&(RADIX_SIZE-1)]+=1;
+		}
+		if (count==0 || counts[(from_keys[0]>>shift)&(RADIX_SIZE-1)]==count){
+			continue;
+		}
+		/*where each value of the bits starts*/
+		sum=0;
+		for (digit=0; digit<RADIX_SIZE; digit++){
+			look_up=counts[digit];
+			counts[digit]=sum;
+			sum+=look_up;
+		}
+		for (look_up=0; look_up<count; look_up++){
+			digit=(from_keys[look_up]>>shift)&(RADIX_SIZE-1);
+			spare_keys[counts[digit]]=from_keys[look_up];
+			spare_order[counts[digit]]=from_order[look_up];
+			counts[digit]+=1;
+		}
+		swap_keys=from_keys;
+		from_keys=spare_keys;
+		spare_keys=swap_keys;
+		swap_order=from_order;
+		from_order=spare_order;
+		spare_order=swap_order;
+	}
+	if (from_order!=order){
+		memcpy(keys, from_keys, sizeof(unsigned int)*count);
+		memcpy(order, from_order, sizeof(int)*count);
+	}
+}
+
+/*
+ * Function: create_run
+ * -------------------
+ * creates an empty temporary file for a run in $TMPDIR (/tmp by default), which is
+ * removed from the directory at once, so that it goes away once it is closed
+ *
+ * returns: descriptor of the file
+ */
+static int create_run(void){
+	char path[4096];
+	char *directory=getenv("TMPDIR");
+	int run;
+	snprintf(path, sizeof(path), "%s/scheduler-run-XXXXXX", directory!=NULL && directory[0]!='\0' ? directory : "/tmp");
+	run=mkstemp(path);
+	if (run==-1){
+		printf("The processes could not be sorted. Try again");
+		exit(0);
+	}
+	unlink(path);
+	return run;
+}
+
+/*
+ * Function: open_run
+ * -------------------
+ * opens a stream through the given buffer on the run, from its start, for as long as the
+ * run is written or read. The stream takes over the descriptor of the run.
+ *
+ * run: descriptor of the run
+ * mode: "wb" to write, "rb" to read
+ * buffer: the buffer, which the stream has to itself until it is closed
+ * buffer_size: size of the buffer
+ *
+ * returns: the stream
+ */
+static FILE *open_run(int run, char *mode, char *buffer, long buffer_size){
+	FILE *file=NULL;
+	if (lseek(run, 0, SEEK_SET)==0){
+		file=fdopen(run, mode);
+	}
+	if (file==NULL || setvbuf(file, buffer, _IOFBF, buffer_size)!=0){
+		printf("The processes could not be sorted. Try again");
+		exit(0);
+	}
+	return file;
+}
+
+/*
+ * Function: close_run
+ * -------------------
+ * closes a stream open_run() opened for writing, which gives its buffer back, keeping
+ * the run open under another descriptor until it is merged
+ *
+ * file: the stream
+ *
+ * returns: descriptor of the run
+ */
+static int close_run(FILE *file){
+	int run=-1;
+	if (!ferror(file) && fflush(file)==0){
+		run=dup(fileno(file));
+	}
+	if (fclose(file)!=0 || run==-1){
+		printf("The processes could not be sorted. Try again");
+		exit(0);
+	}
+	return run;
+}
+
+/*
+ * Function: write_run
+ * -------------------
+ * writes the processes of the chunk, in the sorted order, into a new run
+ *
+ * chunk: the chunk, sorted by radix_sort()
+ * count: number of the processes
+ * buffer: buffer the run is written through
+ * buffer_size: size of the buffer
+ *
+ * returns: descriptor of the run, to be read from the start by merge_runs()
+ */
+static int write_run(chunk_t *chunk, int count, char *buffer, long buffer_size){
+	FILE *file=open_run(create_run(), "wb", buffer, buffer_size);
+	int look_up;
+	for (look_up=0; look_up<count; look_up++){
+		fwrite(&chunk->processes[chunk->order[0][look_up]], sizeof(pcb_t), 1, file);
+	}
+	return close_run(file);
+}
+
+/*
+ * Function: merge_group
+ * -------------------
+ * merges the runs into a new one, which goes in their place in order of the file
+ *
+ * runs: the runs, in order of the file
+ * count: number of the runs
+ * buffer: buffer the new run is written through
+ * buffer_size: size of the buffer of every run while it is written or read
+ *
+ * returns: descriptor of the new run
+ */
+static int merge_group(int *runs, int count, char *buffer, long buffer_size){
+	FILE *output=open_run(create_run(), "wb", buffer, buffer_size);
+	merge_runs(runs, count, output, NULL, buffer_size);
+	return close_run(output);
+}
+
+/*
+ * Function: merge_runs
+ * -------------------
+ * merges the runs into the output run or the binary trace file, taking the process with
+ * the smallest entry time of the next processes of all the runs each time (see
+ * is_before_head()). The runs are closed, which removes them.
+ *
+ * runs: the runs, in order of the file
+ * count: number of the runs
+ * output: run the processes are written into, NULL if they are written by the writer
+ * writer: writer of the binary trace file, if there is no output run
+ * buffer_size: size of the buffer every run is read through
+ *
+ * returns: none
+ */
+static void merge_runs(int *runs, int count, FILE *output, trace_writer_t *writer, long buffer_size){
+	merge_t merge;
+	char *buffers=allocate(count*buffer_size); //buffers the runs are read through
+	int run;
+	int look_up;
+
+	merge.files=allocate(sizeof(FILE *)*count);
+	merge.heads=allocate(sizeof(pcb_t)*count);
+	merge.heap=allocate(sizeof(int)*count);
+	merge.size=0;
+	for (look_up=0; look_up<count; look_up++){
+		merge.files[look_up]=open_run(runs[look_up], "rb", buffers+look_up*buffer_size, buffer_size);
+		if (fread(&merge.heads[look_up], sizeof(pcb_t), 1, merge.files[look_up])==1){
+			merge.heap[merge.size]=look_up;
+			merge.size+=1;
+		}
+	}
+	for (look_up=merge.size/2-1; look_up>=0; look_up--){
+		sift_head(&merge, look_up);
+	}
+	while (merge.size>0){
+		run=merge.heap[0];
+		if (output!=NULL){
+			fwrite(&merge.heads[run], sizeof(pcb_t), 1, output);
+		}
+		else{
+			write_trace_process(writer, &merge.heads[run]);
+		}
+		/*the run goes on with its next process, or leaves the heap once it has none*/
+		if (fread(&merge.heads[run], sizeof(pcb_t), 1, merge.files[run])!=1){
+			merge.size-=1;
+			merge.heap[0]=merge.heap[merge.size];
+		}
+		sift_head(&merge, 0);
+	}
+	for (look_up=0; look_up<count; look_up++){
+		fclose(merge.files[look_up]);
+	}
+	free(buffers);
+	free(merge.files);
+	free(merge.heads);
+	free(merge.heap);
+}
+
+/*
+ * Function: is_before_head
+ * -------------------
+ * Checks whether the next process of the first run goes before the next process of the
+ * second one: if it enters first or, if they enter at the same time, the first run is
+ * earlier in the file
+ *
+ * merge: the runs being merged
+ * first: the first run
+ * second: the second run
+ *
+ * returns: 1 if the process of the first run goes first, 0 otherwise
+ */
+static int is_before_head(merge_t *merge, int first, int second){
+	int first_entry=merge->heads[first].entryTime;
+	int second_entry=merge->heads[second].entryTime;
+	if (first_entry!=second_entry){
+		return first_entry<second_entry;
+	}
+	return first<second;
+}
+
+/*
+ * Function: sift_head
+ * -------------------
+ * moves the run down the heap while the next process of any of its children goes before
+ * its own
+ *
+ * merge: the runs being merged
+ * position: position of the run in the heap
+ *
+ * returns: none
+ */
+static void sift_head(merge_t *merge, int position){
+	int *heap=merge->heap;
+	int child;
+	int run;
+	while (2*position+1<merge->size){
+		child=2*position+1;
+		//picking the child which goes first
+		if (child+1<merge->size && is_before_head(merge, heap[child+1], heap[child])){
+			child+=1;
+		}
+		if (!is_before_head(merge, heap[child], heap[position])){
+			break;
+		}
+		run=heap[position];
+		heap[position]=heap[child];
+		heap[child]=run;
+		position=child;
+	}
+}
+
+/*
+ * Function: allocate
+ * -------------------
+ * allocates the memory the sort needs, stopping the program if there is not enough of it
+ *
+ * size: number of bytes
+ *
+ * returns: the memory
+ */
+static void *allocate(size_t size){
+	void *memory=malloc(size>0 ? size : 1);
+	if (memory==NULL){
+		printf("There is not enough memory for the processes");
+		exit(0);
+	}
+	return memory;
+}
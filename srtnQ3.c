@@ -3,383 +3,222 @@
  * Start date: 01/10/2021
  * Last modified: 07/08/2021
  * -------------------------
- * 
- * The following application is a simulation of the preemptive SRTN(q=3) scheduling 
- * algorithm. It gets the information about each process from the file, where each
- * line represents a singe process in form of:
- * 		[Process Name] [Arrival Time] [Service Time] [Deadline]. 
- *  It schedules the processes accordingly (choosing the shortest remaining time 
- *	process next and switching to the next one after 3 seconds or if the current 
- *	one is completed) and then prints out the main events:
- *		- when the new process enters
- *		- when any of the processes finishes execution
- *		- which process is currently running ( when any of the events above happen)
  *
- * Moreover, it saves information about each of the processes into results-2.txt
- * in form of:
- * 		[Process name] [Wait time] [Turnaround Time] [Deadline Met]
+ * The following is the preemptive SRTN(q=3) scheduling policy for the simulation core
+ * (see scheduler.c). It schedules the processes accordingly (choosing the shortest
+ * remaining time process next and switching to the next one after 3 seconds or if the
+ * current one is completed).
+ *
+ * While only a few processes wait for a CPU, they are kept in a small queue searched
+ * all at once (see small_queue.c); once there are more, they are kept in a heap.
+ *
+ * The results are saved into results-2.txt.
  */
 
-#include <stdio.h>      /* standard I/O routines */
-#include <stdlib.h>     /* needed for exit function */
-#include <string.h>     /* string operations */
-#define MAX 100
-
-/*Special enumerated data type for process state*/
-typedef enum {
-	READY, RUNNING, EXIT
-} process_state_t;
+#include <stdlib.h>     /* calloc */
+#include "scheduler.h"
 
-/* C data structure used as process control block. The scheduler should create
-one instance per running process in the system*/
+/* Run queue of a CPU: the small queue while few processes wait, the heap otherwise*/
 typedef struct{
-	char processname[11]; // A string that identifies the process
-	
-	/*Times are measured in seconds*/
-	int entryTime; // The time process enteres system
-	int serviceTime; //The total CPU time required by the process
-	int remainingTime; //Remaining service time until completion 
-	
-	int deadline; //The expected turnaround time
-	
-	int execTime; //The time when process starts the execution
-	process_state_t state; //current process state(e.g. READY)
-} pcb_t;
-
-
-
-
-
-/*global variables*/
-int rear= 0; //points at the last inserted process
-pcb_t queue[MAX];
+	small_queue_t small; //processes in order of arrival, by remaining time
+	heap_t heap; //processes ordered by remaining time
+	int in_heap; //1 while the processes are in the heap
+} run_queue_t;
 
 /*functions*/
-void add_empty(int count);
-void insert();
-void fill_empy_process();
-void new_process(FILE *fp, int total_processes);
-void remaining_processes(int time, int total_processes, int q, int process_to_run);
-int add_empty_processes(FILE *fp);
-void summarize (pcb_t process, int time);
-int find_next();
-void clear_output_file();
+static int is_before_remaining(simulation_t *sim, int first, int second);
+static void srtn_on_start(simulation_t *sim);
+static void srtn_on_arrival(simulation_t *sim, int cpu, int place, int time);
+static int srtn_select_next(simulation_t *sim, int cpu, int time, int running);
+static void srtn_on_preempt(simulation_t *sim, int cpu, int place, int time);
+static void srtn_on_end(simulation_t *sim);
+static void to_heap(run_queue_t *run_queue);
+static void to_small(simulation_t *sim, run_queue_t *run_queue);
+
+policy_t srtn_policy={"srtn", 2, 3, 0, 0, srtn_on_start, srtn_on_arrival, srtn_select_next, srtn_on_preempt, NULL, srtn_on_end, NULL, NULL, NULL};
 
 
 /*
- * Function: main 
- * --------------
- * opens the file for reading from it, checking whether the user input is valid. 
- * if the user did not specify the file to read from, opens the default "processes.txt",
- * otherwise opens the specified file. 
- *
- * calls the clear_output_file() function to clear the "results-2.txt" file
- *
- * calls the add_empty_processes() function to initialize all the processes with default numbers
+ * Function: is_before_remaining
+ * -------------------
+ * Checks whether the first process has shorter remaining time than the second one.
+ * If two processes have the same remaining time, the one which entered the system
+ * first goes first.
  *
- * calls the scheduling functions to schedule the processes with SRTN(q=3) approach
+ * sim: the simulation
+ * first: place of the first process in the queue
+ * second: place of the second process in the queue
  *
- * argc: argument counter, which is the number of arguments the user input
- * argv: array containing all the arguments the user input 
- * 
- * returns: none
+ * returns: 1 if the first process goes before the second one, 0 otherwise
  */
-int main(int argc, char* argv[])
-{
-	/*open files*/
-	FILE *fp;
-	if (argc>1){
-		fp = fopen (argv[1], "r");
-	}
-	else{
-		fp = fopen ("processes.txt", "r");
+static int is_before_remaining(simulation_t *sim, int first, int second){
+	int *remaining=sim->queue.remainingTime;
+	if (remaining[first]!=remaining[second]){
+		return remaining[first]<remaining[second];
 	}
-	
-	/*handling the non-existent file*/
-	if (fp==NULL){
-		printf("The file could not be open. Try again");
-		exit(0); 
-	}
-	
-	/*clear the output file*/
-	clear_output_file();
-	
-	/*initialize time*/
-	int time=0;
-	int total_processes;
-	
-	/*counting number of lines in the file and adding and empty processes to the queue
-	for each line*/
-	total_processes=add_empty_processes(fp);
-	
-	/*adding processes and working on them*/
-	new_process(fp, total_processes);
-	
-	/*closing the open file*/
-	fclose(fp);
-	exit(0); 
+	return sim->queue.arrival[first]<sim->queue.arrival[second];
 }
 
 /*
- * Function: clear_output_file
+ * Function: srtn_on_start
  * -------------------
- * clears the content of the "results-2.txt" file
+ * creates an empty run queue for every CPU of the simulation
  *
- * returns: none
- */
-void clear_output_file(){
-	fclose(fopen("results-2.txt", "w"));
-}
-
-/*
- * Function: insert
- * -------------------
- * inserts the process into the queue, checking whether total number does not excess the
- * limitation. Places the rear pointer at the last inserted process.
- * 
- * process: the instance of pcb_t struct, which is to be inserted
+ * sim: the simulation
  *
  * returns: none
  */
-void insert(pcb_t process){
-	if (rear == MAX - 1){
-		printf("The number of processes is exceeding the limit");
-		return;
+static void srtn_on_start(simulation_t *sim){
+	run_queue_t *run_queues=calloc(sim->cpus, sizeof(run_queue_t));
+	int look_up;
+	if (run_queues==NULL){
+		out_of_memory(sim);
 	}
-	else{
-		queue[rear]= process;
-		rear=rear+1;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		run_queues[look_up].heap.is_before=is_before_remaining;
+		run_queues[look_up].heap.sim=sim;
 	}
+	sim->policy_data=run_queues;
 }
 
 /*
- * Function: add_empty
+ * Function: srtn_on_end
  * -------------------
- * adds the process with all the default attributes to the given position
+ * frees the run queues of the simulation
  *
- * count: position of the process to be deleted
+ * sim: the simulation
  *
  * returns: none
  */
-void add_empty(int count){
-	pcb_t process; 
-	strcpy(process.processname, "-1");
-	process.entryTime= -1;
-	process.serviceTime =-1;
-	process.remainingTime=-1;
-	process.execTime=-1;
-	queue[count]= process;
+static void srtn_on_end(simulation_t *sim){
+	run_queue_t *run_queues=sim->policy_data;
+	int look_up;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		small_free(&run_queues[look_up].small);
+		free(run_queues[look_up].heap.places);
+	}
+	free(run_queues);
+	sim->policy_data=NULL;
 }
 
 /*
- * Function: new_process
+ * Function: srtn_on_arrival
  * -------------------
- * works on scheduling the processes, when there are processes that are NOT read from the
- * file. reads the file line by line, inserting the processes to the queue at their 
- * entry time, while allowing other process to run
+ * adds the process to the run queue of the CPU, moving the run queue into the heap
+ * once the small queue is full
  *
- * fp: file to be read from
- * total_processes: total number of processes to be inserted
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
  *
  * returns: none
  */
-void new_process(FILE *fp, int total_processes){
-	/* initialization*/
-	pcb_t process;
-	size_t len = 128; //maximum length of line is 128 char
-	char *line= malloc(sizeof(char)*len); //allocating space
-	int time=0; //current time in seconds
-	int inserted; // shows whether the character was inserted or not
-	int q=0; //quantum counter
-	int process_to_run; 
-	
-	while (fgets(line, len, fp)!=NULL){ //while there is a line in the file to be read
-		/*reading new line into process*/
-		sscanf (line, "%10s%d%d%d", process.processname, &process.entryTime, &process.serviceTime, &process.deadline);
-		process.remainingTime=process.serviceTime;
-		inserted=0; //reinitializing to 0 for every new line
-		
-		while (inserted==0){
-			queue[rear].state=READY;// process is in a ready state once inserted
-			
-			/*insert the process once the time reaches it's enrty time*/
-			if (process.entryTime <= time){
-				insert(process); 
-				printf("Time %d: %10s has entered the system\n", process.entryTime, process.processname );
-				inserted = 1; //shows that it was inserted
-			}
-			
-			//once the quantum reaches 3, reinitialize it to 0 to look for a new process 
-			if (q==3){
-				q=0;
-			}
-			
-			//if the quantum is or the current process is completed
-			if (q==0 || !strcmp(queue[process_to_run].processname, "-1" )){
-				process_to_run=find_next(); //search for the next process
-				queue[process_to_run].state=RUNNING; 
-			}
-			
-			//once the process started running for the 1st time, its exec time is recorded
-			if( queue[process_to_run].remainingTime== queue[process_to_run].serviceTime){
-				queue[process_to_run].execTime=time;
-			}
-	
-			if (strcmp(process.processname,queue[process_to_run].processname )){
-				printf("Time %d: %10s is in the running state\n", time, queue[process_to_run].processname );	
-			}
-			/*deduct one second, if remaining time is more than 0*/
-			if (queue[process_to_run].remainingTime!=0){
-				queue[process_to_run].remainingTime-=1;
-			}
-			//increment of the time and quantum
-			time+=1;
-			q+=1;
-			
-			/*once remaining time is 0, process has finished the execution*/
-			if (queue[process_to_run].remainingTime==0){
-				queue[process_to_run].state=EXIT;
-				printf("Time %d: %10s has finished execution\n", time, queue[process_to_run].processname);
-				summarize(queue[process_to_run], time);
-				add_empty(process_to_run); //process is removed from the queue
-				total_processes-=1; //since the process is deleted the total number of processes to be processed is decreased
-				q=0; //reset quantum to 0, once the process is deleted
-			}
-		}
+static void srtn_on_arrival(simulation_t *sim, int cpu, int place, int time){
+	run_queue_t *run_queue=(run_queue_t *)sim->policy_data+cpu;
+	if (!run_queue->in_heap && run_queue->small.size==SMALL_QUEUE_SIZE){
+		to_heap(run_queue);
+	}
+	if (run_queue->in_heap){
+		heap_insert(&run_queue->heap, place);
+	}
+	else{
+		small_insert(sim, &run_queue->small, place, sim->queue.remainingTime[place], 0, 0);
 	}
-	free(line); //empty allocated space
-	/*after all the processes are added, work on the processes which remain in the system*/
-	remaining_processes(time, total_processes, q, process_to_run);
-	
 }
 
 /*
- * Function: remaining_processes
- * ------------------------------
- * works on scheduling the processes, when ALL the processes are read from the
- * file. works on the remaining processes, scheduling them according to SRTN(q=3) algorithm
- *
- * time: time which the new_process() stopped running at
- * total_processe: number of processes in the system awaiting to be processed
- * process_to_run: process that was in a state of running
- *
- * returns: none
+ * Function: srtn_select_next
+ * -------------------
+ * Find the process with the shortest remaining time from the running process and
+ * the run queue of the CPU. If two processes have the same remaining time, the one which
+ * entered the system first is chosen. It is either the running process or the first
+ * process with the shortest remaining time in the small queue (which is in order of
+ * arrival), or the one at the top of the heap.
+ * The running process is the only one whose remaining time changes, so it is kept
+ * out of the run queue.
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * time: time, right at the moment when the process is being searched for
+ * running: process that is in a state of running (-1 if none)
+ *
+ * returns: the process with the shortest remaining time, -1 if there are no processes
  */
-void remaining_processes(int time, int total_processes, int q, int process_to_run){
-	/*works on the remaining processes*/
-	while(total_processes>0){ 
-		//once the quantum reaches 3, reinitialize it to 0 to look for a new process 
-		if (q==3){
-			q=0;
-		}
-		//if the quantum is 0 or the current process is completed
-		if (q==0 || !strcmp(queue[process_to_run].processname, "-1" )){
-			process_to_run=find_next(); //search for the next process
-			queue[process_to_run].state=RUNNING;
-			printf("Time %d: %10s is in the running state\n", time, queue[process_to_run].processname );
-		}
-		//once the process started running for the 1st time, its exec time is recorded
-		if( queue[process_to_run].remainingTime == queue[process_to_run].serviceTime){
-			queue[process_to_run].execTime=time;
-		}
-		
-		/*deduct one second, if remaining time is more than 0*/
-		if (queue[process_to_run].remainingTime!=0){
-			queue[process_to_run].remainingTime-=1;
-		}
-		//increment of the time and quantum
-		time+=1;
-		q+=1;
-		/*once remaining time is 0, process has finished the execution*/
-		if (queue[process_to_run].remainingTime==0){
-			queue[process_to_run].state=EXIT;
-			printf("Time %d: %10s has finished execution\n", time, queue[process_to_run].processname);
-			summarize(queue[process_to_run], time);
-			add_empty(process_to_run); //process is removed from the queue
-			total_processes-=1; //since the process is deleted the total number of processes to be processed is decreased
-			q=0; //reset quantum to 0, once the process is deleted
+static int srtn_select_next(simulation_t *sim, int cpu, int time, int running){
+	run_queue_t *run_queue=(run_queue_t *)sim->policy_data+cpu;
+	small_queue_t *small=&run_queue->small;
+	heap_t *heap=&run_queue->heap;
+	int position;
+	int place;
+	/*once few processes are left in the heap, the small queue is faster*/
+	if (run_queue->in_heap && heap->size<=SMALL_QUEUE_SIZE/4){
+		to_small(sim, run_queue);
+	}
+	if (run_queue->in_heap){
+		place=heap->places[0];
+		if (running!=-1 && !is_before_remaining(sim, place, running)){
+			return running;
 		}
+		heap_delete(heap, place);
+		return place;
+	}
+	position=find_first_min(small->keys, NULL, NULL, time, small->size);
+	if (position==-1 || (running!=-1 && !is_before_remaining(sim, small->places[position], running))){
+		return running;
 	}
+	return small_remove(small, position);
 }
 
 /*
- * Function: find_next
+ * Function: srtn_on_preempt
  * -------------------
- * Find the process with the shortest remaining time from all the processes in 
- * the system
+ * puts the process, which was running, back into the run queue of the CPU
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
  *
- * returns: the process with the shortest remaining time
+ * returns: none
  */
-int find_next(){
-	int process_to_run=0;
-	int shortest_rem_time= (int) (long) NULL;
-	int look_up=0;
-	//Looping from the first process till the last inserted to the queue
-	while (look_up<rear){
-		if (strcmp(queue[look_up].processname, "-1" )){
-			//finding the current shortest remaining time process
-			if (shortest_rem_time>queue[look_up].remainingTime || shortest_rem_time == (int) (long) NULL){
-				process_to_run=look_up;
-				shortest_rem_time=queue[look_up].remainingTime;
-			}
-		}
-		look_up+=1;
-	}
-	return process_to_run;
+static void srtn_on_preempt(simulation_t *sim, int cpu, int place, int time){
+	srtn_on_arrival(sim, cpu, place, time);
 }
 
-
 /*
- * Function: add_empty_processes
- * -----------------------------
- * loops through each line of the file ( which corresponds to a single process) 
- * and inserts the default empty processes there ( by calling add_empty()).
- * Counts how many processes are supposed to be processed
+ * Function: to_heap
+ * -------------------
+ * moves the processes of the small queue into the heap
  *
- * fp: file to be read from
+ * run_queue: the run queue
  *
- * returns: number of processes to be processed
+ * returns: none
  */
-int add_empty_processes(FILE *fp){
-	char c;
-	int count=0;
-	for (c= getc(fp); c!= EOF; c= getc(fp))
-		if (c =='\n'){
-			add_empty(count); //adds an empty process to the queue
-			count+=1; //increased when a single line of a while is read
-		}
-	rewind(fp); //reset the pointer back to the beginning of the file
-	return count;
+static void to_heap(run_queue_t *run_queue){
+	while (run_queue->small.size>0){
+		heap_insert(&run_queue->heap, small_remove(&run_queue->small, run_queue->small.size-1));
+	}
+	run_queue->in_heap=1;
 }
 
 /*
- * Function: summarize
+ * Function: to_small
  * -------------------
- * Calculates process's wait time, turnaround time and determines whether the 
- * deadline was met. 
- * Writes all that information about the process to the file "results-2.txt"
+ * moves the processes of the heap into the small queue
  *
- * process: process, that summary is about
- * time: time, when the process completed execution
+ * sim: the simulation
+ * run_queue: the run queue
  *
  * returns: none
  */
-void summarize (pcb_t process, int time){
-	/*Initialization*/
-	int deadline_satisfied=0;
-	int wait_time;
-	int turnaround_time;
-	/*Open the file*/
-	FILE *fpw;
-	fpw = fopen ("results-2.txt", "a");
-	
-	turnaround_time=time-process.entryTime; //calculating the turnaround time
-	wait_time=process.execTime-process.entryTime; //calculating the wait time
-	/*Determining whether the deadline is satisfied*/
-	if (turnaround_time<=process.deadline){
-		deadline_satisfied = 1;
+static void to_small(simulation_t *sim, run_queue_t *run_queue){
+	heap_t *heap=&run_queue->heap;
+	int place;
+	while (heap->size>0){
+		place=heap->places[heap->size-1];
+		heap_delete(heap, place);
+		small_insert(sim, &run_queue->small, place, sim->queue.remainingTime[place], 0, 0);
 	}
-	// Adding the summary to the file
-	fprintf(fpw, "%s %d %d %d\n", process.processname, wait_time, turnaround_time, deadline_satisfied);
-	fclose(fpw);
+	run_queue->in_heap=0;
 }
@@ -0,0 +1,371 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * The following is the preemptive stride scheduling policy for the simulation core (see
+ * scheduler.c), a proportional share policy: each process gets a share of its CPU in
+ * proportion to its tickets. It schedules the processes accordingly:
+ *		- every process has a stride, STRIDE1 / its tickets, and a pass, which grows by
+ *		  the stride for every second the process runs
+ *		- the process with the smallest pass runs (the one that entered first, if the
+ *		  passes are the same) and it is preempted once another one has a smaller pass
+ *		- a new process starts with the pass of the CPU, the smallest pass of the
+ *		  processes on it, so that it neither waits for the others to catch up with it
+ *		  nor runs alone until it catches up with them
+ * A process with twice as many tickets therefore runs twice as long. How close the
+ * shares are to the tickets is measured by the share deviation (see summarize()).
+ *
+ * The waiting processes of every CPU are kept in a heap ordered by their passes, so the
+ * next process is found in O(log N) time. The pass of the running process is only brought
+ * up to date when it is looked at, from how much its remaining time went down: a context
+ * switch to it does not count, so it is never preempted before it runs.
+ *
+ * The results are saved into results-5.txt.
+ */
+
+#include <stdlib.h>     /* calloc, realloc */
+#include <limits.h>     /* INT_MAX, LLONG_MAX */
+#include "scheduler.h"
+
+/* Run queues of the CPUs and the passes of the processes, kept by place*/
+typedef struct{
+	heap_t *heaps; //waiting processes of every CPU, ordered by pass
+	long long *cpu_passes; //pass of every CPU, which the new processes start with
+	long long *passes; //pass of the process
+	int *counted; //remaining time of the process when its pass was last brought up to date
+	int capacity; //number of places allocated for
+} stride_t;
+
+/*functions*/
+static int is_before_pass(simulation_t *sim, int first, int second);
+static void stride_on_start(simulation_t *sim);
+static void stride_on_arrival(simulation_t *sim, int cpu, int place, int time);
+static int stride_select_next(simulation_t *sim, int cpu, int time, int running);
+static void stride_on_preempt(simulation_t *sim, int cpu, int place, int time);
+static void stride_on_end(simulation_t *sim);
+static int stride_decide_at(simulation_t *sim, int cpu, int running, int time);
+static void stride_save(simulation_t *sim, FILE *fp);
+static void stride_load(simulation_t *sim, FILE *fp);
+static void grow_places(simulation_t *sim, stride_t *stride);
+static long long stride_of(simulation_t *sim, int place);
+static void advance(simulation_t *sim, stride_t *stride, int place);
+static long long cpu_pass(simulation_t *sim, stride_t *stride, int cpu);
+
+policy_t stride_policy={"stride", 5, 1, 0, 0, stride_on_start, stride_on_arrival, stride_select_next, stride_on_preempt, NULL, stride_on_end, stride_decide_at, stride_save, stride_load};
+
+
+/*
+ * Function: is_before_pass
+ * -------------------
+ * compares the processes by pass, and by order of arrival if the passes are the same
+ *
+ * sim: the simulation
+ * first: place of the first process
+ * second: place of the second process
+ *
+ * returns: 1 if the first process goes before the second one, 0 otherwise
+ */
+static int is_before_pass(simulation_t *sim, int first, int second){
+	stride_t *stride=sim->policy_data;
+	if (stride->passes[first]!=stride->passes[second]){
+		return stride->passes[first]<stride->passes[second];
+	}
+	return sim->queue.arrival[first]<sim->queue.arrival[second];
+}
+
+/*
+ * Function: stride_on_start
+ * -------------------
+ * creates an empty run queue for every CPU of the simulation
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+static void stride_on_start(simulation_t *sim){
+	stride_t *stride=calloc(1, sizeof(stride_t));
+	int look_up;
+	if (stride==NULL){
+		out_of_memory(sim);
+	}
+	stride->heaps=calloc(sim->cpus, sizeof(heap_t));
+	stride->cpu_passes=calloc(sim->cpus, sizeof(long long));
+	if (stride->heaps==NULL || stride->cpu_passes==NULL){
+		out_of_memory(sim);
+	}
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		stride->heaps[look_up].is_before=is_before_pass;
+		stride->heaps[look_up].sim=sim;
+	}
+	sim->policy_data=stride;
+}
+
+/*
+ * Function: stride_on_end
+ * -------------------
+ * frees the run queues and the passes of the simulation
+ *
+ * sim: the simulation
+ *
+ * returns: none
+ */
+static void stride_on_end(simulation_t *sim){
+	stride_t *stride=sim->policy_data;
+	int look_up;
+	for (look_up=0; look_up<sim->cpus; look_up++){
+		free(stride->heaps[look_up].places);
+	}
+	free(stride->heaps);
+	free(stride->cpu_passes);
+	free(stride->passes);
+	free(stride->counted);
+	free(stride);
+	sim->policy_data=NULL;
+}
+
+/*
+ * Function: grow_places
+ * -------------------
+ * allocates the passes for as many places as the queue of the simulation has
+ *
+ * sim: the simulation
+ * stride: the run queues and the passes
+ *
+ * returns: none
+ */
+static void grow_places(simulation_t *sim, stride_t *stride){
+	stride->capacity=sim->capacity;
+	stride->passes=realloc(stride->passes, sizeof(long long)*stride->capacity);
+	stride->counted=realloc(stride->counted, sizeof(int)*stride->capacity);
+	if (stride->passes==NULL || stride->counted==NULL){
+		out_of_memory(sim);
+	}
+}
+
+/*
+ * Function: stride_of
+ * -------------------
+ * finds the stride of the process, by which its pass grows every second it runs
+ *
+ * sim: the simulation
+ * place: place of the process in the queue
+ *
+ * returns: the stride, at least 1
+ */
+static long long stride_of(simulation_t *sim, int place){
+	long long stride=STRIDE1/sim->queue.tickets[place];
+	return stride>0 ? stride : 1;
+}
+
+/*
+ * Function: advance
+ * -------------------
+ * adds the seconds the running process has run since it was last looked at to its pass
+ *
+ * sim: the simulation
+ * stride: the run queues and the passes
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+static void advance(simulation_t *sim, stride_t *stride, int place){
+	int remaining=sim->queue.remainingTime[place];
+	stride->passes[place]+=stride_of(sim, place)*(stride->counted[place]-remaining);
+	stride->counted[place]=remaining;
+}
+
+/*
+ * Function: cpu_pass
+ * -------------------
+ * finds the pass of the CPU: the smallest pass of the running process and the waiting
+ * ones, which never goes back (it stays the same while the CPU has no processes)
+ *
+ * sim: the simulation
+ * stride: the run queues and the passes
+ * cpu: index of the CPU
+ *
+ * returns: the pass of the CPU
+ */
+static long long cpu_pass(simulation_t *sim, stride_t *stride, int cpu){
+	heap_t *heap=&stride->heaps[cpu];
+	int running=sim->cpu[cpu].process_to_run;
+	long long smallest=LLONG_MAX;
+	if (running!=-1){
+		advance(sim, stride, running);
+		smallest=stride->passes[running];
+	}
+	if (heap->size>0 && stride->passes[heap->places[0]]<smallest){
+		smallest=stride->passes[heap->places[0]];
+	}
+	if (smallest!=LLONG_MAX && smallest>stride->cpu_passes[cpu]){
+		stride->cpu_passes[cpu]=smallest;
+	}
+	return stride->cpu_passes[cpu];
+}
+
+/*
+ * Function: stride_on_arrival
+ * -------------------
+ * adds the process to the run queue of the CPU, with the pass of the CPU
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
+ *
+ * returns: none
+ */
+static void stride_on_arrival(simulation_t *sim, int cpu, int place, int time){
+	stride_t *stride=sim->policy_data;
+	if (place>=stride->capacity){
+		grow_places(sim, stride);
+	}
+	stride->passes[place]=cpu_pass(sim, stride, cpu);
+	stride->counted[place]=sim->queue.remainingTime[place];
+	heap_insert(&stride->heaps[cpu], place);
+}
+
+/*
+ * Function: stride_select_next
+ * -------------------
+ * brings the pass of the running process up to date. The waiting process with the
+ * smallest pass runs next, if it goes before the running process; otherwise the
+ * running process keeps running.
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * time: time, right at the moment when the process is being searched for
+ * running: process that is in a state of running (-1 if none)
+ *
+ * returns: the process to run, -1 if there are no processes
+ */
+static int stride_select_next(simulation_t *sim, int cpu, int time, int running){
+	stride_t *stride=sim->policy_data;
+	heap_t *heap=&stride->heaps[cpu];
+	int place;
+
+	if (running!=-1){
+		advance(sim, stride, running);
+	}
+	if (heap->size==0){
+		return running;
+	}
+	place=heap->places[0];
+	if (running!=-1 && !is_before_pass(sim, place, running)){
+		return running;
+	}
+	heap_delete(heap, place);
+	return place;
+}
+
+/*
+ * Function: stride_on_preempt
+ * -------------------
+ * puts the process, which was running, back into the run queue of the CPU
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * place: place of the process in the queue
+ * time: current time
+ *
+ * returns: none
+ */
+static void stride_on_preempt(simulation_t *sim, int cpu, int place, int time){
+	stride_t *stride=sim->policy_data;
+	heap_insert(&stride->heaps[cpu], place);
+}
+
+/*
+ * Function: stride_decide_at
+ * -------------------
+ * finds the time at which the pass of the running process goes past the smallest pass
+ * of the waiting ones, once the context switch to it is over: then the waiting process
+ * runs, although nothing changed
+ *
+ * sim: the simulation
+ * cpu: index of the CPU
+ * running: process that is in a state of running (-1 if none)
+ * time: current time
+ *
+ * returns: the time, INT_MAX if no process is running or waiting
+ */
+static int stride_decide_at(simulation_t *sim, int cpu, int running, int time){
+	stride_t *stride=sim->policy_data;
+	heap_t *heap=&stride->heaps[cpu];
+	long long step;
+	long long gap; //how far the pass of the running process is behind the smallest waiting one
+	long long seconds; //seconds until the waiting process goes before the running one
+	int waiting;
+
+	if (running==-1 || heap->size==0){
+		return INT_MAX;
+	}
+	waiting=heap->places[0];
+	step=stride_of(sim, running);
+	gap=stride->passes[waiting]-stride->passes[running];
+	seconds=gap/step+1;
+	/*with the same passes, the process which entered first goes first*/
+	if (gap%step==0 && sim->queue.arrival[waiting]<sim->queue.arrival[running]){
+		seconds=gap/step;
+	}
+	if (seconds<1){
+		seconds=1;
+	}
+	seconds+=sim->cpu[cpu].overhead;
+	return seconds>INT_MAX-time ? INT_MAX : time+seconds;
+}
+
+/*
+ * Function: stride_save
+ * -------------------
+ * writes the passes of the CPUs and of the processes into the checkpoint
+ *
+ * sim: the simulation
+ * fp: the checkpoint file
+ *
+ * returns: none
+ */
+static void stride_save(simulation_t *sim, FILE *fp){
+	stride_t *stride=sim->policy_data;
+	int places=sim->rear<stride->capacity ? sim->rear : stride->capacity;
+	fwrite(stride->cpu_passes, sizeof(long long), sim->cpus, fp);
+	fwrite(&places, sizeof(int), 1, fp);
+	fwrite(stride->passes, sizeof(long long), places, fp);
+	fwrite(stride->counted, sizeof(int), places, fp);
+}
+
+/*
+ * Function: stride_load
+ * -------------------
+ * reads what stride_save() wrote, and puts every waiting process back into the heap of
+ * the CPU whose run queue it is in. As no two processes go at the same time, the heaps
+ * choose the same processes as before.
+ *
+ * sim: the simulation
+ * fp: the checkpoint file
+ *
+ * returns: none
+ */
+static void stride_load(simulation_t *sim, FILE *fp){
+	stride_t *stride=sim->policy_data;
+	process_table_t *queue=&sim->queue;
+	int places;
+	int place;
+
+	read_part(fp, stride->cpu_passes, sizeof(long long), sim->cpus);
+	read_part(fp, &places, sizeof(int), 1);
+	if (places<0 || places>sim->capacity){
+		printf("The checkpoint file is damaged");
+		exit(0);
+	}
+	if (sim->capacity>0){
+		grow_places(sim, stride);
+	}
+	read_part(fp, stride->passes, sizeof(long long), places);
+	read_part(fp, stride->counted, sizeof(int), places);
+	for (place=0; place<places; place++){
+		if (IS_LIVE(queue, place) && queue->run_queue[place]!=-1){
+			heap_insert(&stride->heaps[queue->run_queue[place]], place);
+		}
+	}
+}
@@ -0,0 +1,243 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Sweep mode: the same processes are simulated with every combination of the given
+ * policies, quantums and numbers of CPUs. The simulations are independent of each other,
+ * so they are run by a pool of threads at the same time, all of them sharing the trace,
+ * which is read from the file only once. Once all of them are done, a table comparing
+ * them is printed out, in the order of the combinations.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* memcpy */
+#include <pthread.h>    /* threads */
+#include "scheduler.h"
+
+/* One combination of the options and the totals of its simulation*/
+typedef struct{
+	policy_t *policy; //policy the processes are scheduled with
+	int quantum; //seconds after which the next process is searched for
+	int cpus; //number of the CPUs
+	long finished; //number of finished processes
+	long total_wait; //sum of the wait times
+	long total_turnaround; //sum of the turnaround times
+	long deadlines_met; //number of processes which met the deadline
+	int end_time; //time when the last process finished
+	long busy_time; //sum of the busy times of the CPUs
+	long migrations; //sum of the migrations of the CPUs
+	long switches; //sum of the context switches of the CPUs
+	long lost_time; //sum of the seconds the CPUs lost on context switches
+	simulation_t *settings; //simulation the costs of the context switches and the levels are taken from
+	sketch_t wait_times; //wait times of the processes
+	sketch_t turnaround_times; //turnaround times of the processes
+} configuration_t;
+
+/* Work shared by the threads of the pool*/
+typedef struct{
+	trace_t *trace; //processes to be simulated
+	configuration_t *configurations; //combinations to be simulated
+	int count; //number of the combinations
+	int next; //the next combination to be taken by a thread
+	pthread_mutex_t lock; //protects the next combination
+} pool_t;
+
+/*functions*/
+static void *work(void *argument);
+static void run_configuration(trace_t *trace, configuration_t *configuration);
+static void print_table(configuration_t *configurations, int count);
+
+
+/*
+ * Function: sweep
+ * -------------------
+ * simulates the trace with every combination of the policies, quantums and numbers of
+ * CPUs, using the given number of threads, and prints out the table comparing them.
+ * Policies that ignore -q (see policy_t) ignore the quantums, and if no quantum is given,
+ * the default one of each policy is used. All the simulations have the same costs of
+ * the context switches and the same levels (for MLFQ).
+ *
+ * trace: processes to be simulated
+ * policies: the policies
+ * policy_count: number of the policies
+ * quanta: the quantums
+ * quantum_count: number of the quantums, 0 to use the default ones
+ * cpu_counts: the numbers of CPUs
+ * cpu_count: number of the numbers of CPUs
+ * jobs: number of threads
+ * settings: simulation the costs of the context switches and the levels are taken from
+ *
+ * returns: none
+ */
+void sweep(trace_t *trace, policy_t **policies, int policy_count, int *quanta, int quantum_count, int *cpu_counts, int cpu_count, int jobs, simulation_t *settings){
+	pool_t pool;
+	pthread_t *threads;
+	int policy_index;
+	int quantum_index;
+	int cpu_index;
+	int look_up;
+	int quantum;
+
+	pool.trace=trace;
+	pool.count=0;
+	pool.next=0;
+	pool.configurations=calloc(policy_count*(quantum_count+1)*cpu_count, sizeof(configuration_t));
+	threads=malloc(sizeof(pthread_t)*jobs);
+	if (pool.configurations==NULL || threads==NULL){
+		printf("There is not enough memory for the processes");
+		exit(0);
+	}
+	/*every combination of the options*/
+	for (policy_index=0; policy_index<policy_count; policy_index++){
+		for (quantum_index=0; quantum_index<quantum_count || quantum_index==0; quantum_index++){
+			quantum=policies[policy_index]->quantum;
+			if (quantum_count>0 && !policies[policy_index]->fixed_quantum){
+				quantum=quanta[quantum_index];
+			}
+			for (cpu_index=0; cpu_index<cpu_count; cpu_index++){
+				pool.configurations[pool.count].policy=policies[policy_index];
+				pool.configurations[pool.count].quantum=quantum;
+				pool.configurations[pool.count].cpus=cpu_counts[cpu_index];
+				pool.configurations[pool.count].settings=settings;
+				pool.count+=1;
+			}
+			//a policy which ignores the quantum is simulated only once for all the quantums
+			if (policies[policy_index]->fixed_quantum){
+				break;
+			}
+		}
+	}
+
+	/*the threads take the combinations one by one until there are none left*/
+	pthread_mutex_init(&pool.lock, NULL);
+	if (jobs>pool.count){
+		jobs=pool.count;
+	}
+	for (look_up=0; look_up<jobs; look_up++){
+		if (pthread_create(&threads[look_up], NULL, work, &pool)!=0){
+			printf("The threads could not be started");
+			exit(0);
+		}
+	}
+	for (look_up=0; look_up<jobs; look_up++){
+		pthread_join(threads[look_up], NULL);
+	}
+	pthread_mutex_destroy(&pool.lock);
+
+	print_table(pool.configurations, pool.count);
+	free(pool.configurations);
+	free(threads);
+}
+
+/*
+ * Function: work
+ * -------------------
+ * keeps simulating the next combination of the pool, until there are none left
+ *
+ * argument: the pool
+ *
+ * returns: NULL
+ */
+static void *work(void *argument){
+	pool_t *pool=argument;
+	int index;
+	while (1){
+		pthread_mutex_lock(&pool->lock);
+		index=pool->next;
+		pool->next+=1;
+		pthread_mutex_unlock(&pool->lock);
+		if (index>=pool->count){
+			return NULL;
+		}
+		run_configuration(pool->trace, &pool->configurations[index]);
+	}
+}
+
+/*
+ * Function: run_configuration
+ * -------------------
+ * simulates the trace with the combination of options, without printing out the events
+ * or writing the results file, and keeps the totals of the simulation
+ *
+ * trace: processes to be simulated
+ * configuration: the combination of options
+ *
+ * returns: none
+ */
+static void run_configuration(trace_t *trace, configuration_t *configuration){
+	simulation_t sim;
+	int look_up;
+
+	init_simulation(&sim, configuration->policy, configuration->cpus);
+	sim.quantum=configuration->quantum;
+	sim.switch_cost=configuration->settings->switch_cost;
+	sim.migration_cost=configuration->settings->migration_cost;
+	sim.levels=configuration->settings->levels;
+	memcpy(sim.level_quanta, configuration->settings->level_quanta, sizeof(sim.level_quanta));
+	sim.boost_period=configuration->settings->boost_period;
+	sim.log_level=LOG_OFF;
+	sim.trace=trace;
+	simulate(&sim);
+
+	configuration->finished=sim.finished;
+	configuration->total_wait=sim.total_wait;
+	configuration->total_turnaround=sim.total_turnaround;
+	configuration->deadlines_met=sim.deadlines_met;
+	configuration->end_time=sim.end_time;
+	sketch_merge(&configuration->wait_times, &sim.wait_times);
+	sketch_merge(&configuration->turnaround_times, &sim.turnaround_times);
+	for (look_up=0; look_up<sim.cpus; look_up++){
+		configuration->busy_time+=sim.cpu[look_up].busy_time;
+		configuration->migrations+=sim.cpu[look_up].migrations;
+		configuration->switches+=sim.cpu[look_up].switches;
+		configuration->lost_time+=sim.cpu[look_up].lost_time;
+	}
+	free_simulation(&sim);
+}
+
+/*
+ * Function: print_table
+ * -------------------
+ * prints out a line for every combination of options: the average and 99th percentile 
+ * of the wait and turnaround time, the share of the processes which met the deadline, the time when the last
+ * process finished, the average utilization of the CPUs, the number of migrations and
+ * context switches and the seconds lost on the context switches
+ *
+ * configurations: the combinations of options
+ * count: number of the combinations
+ *
+ * returns: none
+ */
+static void print_table(configuration_t *configurations, int count){
+	configuration_t *configuration;
+	double average_wait;
+	double average_turnaround;
+	double met;
+	double utilization;
+	int look_up;
+
+	printf("%-10s %7s %5s %10s %12s %10s %15s %15s %13s %10s %11s %10s %10s %10s\n", "policy", "quantum", "cpus", "processes", "avg_wait", "p99_wait",
+		"avg_turnaround", "p99_turnaround", "deadlines_met", "end_time", "utilization", "migrations", "switches",
+		"lost_time");
+	for (look_up=0; look_up<count; look_up++){
+		configuration=&configurations[look_up];
+		average_wait=0;
+		average_turnaround=0;
+		met=0;
+		utilization=0;
+		if (configuration->finished>0){
+			average_wait=(double)configuration->total_wait/configuration->finished;
+			average_turnaround=(double)configuration->total_turnaround/configuration->finished;
+			met=(double)configuration->deadlines_met/configuration->finished;
+		}
+		if (configuration->end_time>0){
+			utilization=(double)configuration->busy_time/((double)configuration->end_time*configuration->cpus);
+		}
+		printf("%-10s %7d %5d %10ld %12.2f %10d %15.2f %15d %13.4f %10d %11.4f %10ld %10ld %10ld\n", configuration->policy->name,
+			configuration->quantum, configuration->cpus, configuration->finished, average_wait,
+			sketch_quantile(&configuration->wait_times, 0.99), average_turnaround,
+			sketch_quantile(&configuration->turnaround_times, 0.99), met, configuration->end_time, utilization,
+			configuration->migrations, configuration->switches, configuration->lost_time);
+	}
+}
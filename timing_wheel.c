@@ -0,0 +1,288 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Hierarchical timing wheel (timing_wheel_t), which keeps a timer for each of any number of
+ * processes, e.g. for the time at which a waiting process can no longer meet its deadline
+ * (see deadline_based.c). A timer is added or cancelled in O(1) time, however many there
+ * are, and the wheel only does work when a timer expires, so the time may jump far ahead.
+ *
+ * The wheel has WHEEL_LEVELS levels of WHEEL_SLOTS slots each. The slots of the lowest
+ * level are single seconds, the slots of every next level are WHEEL_SLOTS times as long,
+ * and a timer is put into the lowest level in which its time is still ahead of the time of
+ * the wheel: a timer whose time differs from it only in the lowest WHEEL_BITS bits goes to
+ * the lowest level, and so on. Once the wheel gets to the start of a slot of a higher level,
+ * its timers are spread over the levels below it, so every timer is moved at most
+ * WHEEL_LEVELS times before it expires. The slots with timers are kept in a bitmap for
+ * every level, so the next one is found without going through the empty ones, and the
+ * start of the next one is kept, so the wheel is not looked at all until then.
+ */
+
+#include <stdlib.h>     /* realloc */
+#include <string.h>     /* memset */
+#include <limits.h>     /* INT_MAX */
+#include "scheduler.h"
+
+/*functions*/
+static void grow_places(simulation_t *sim, timing_wheel_t *wheel);
+static void link_timer(timing_wheel_t *wheel, int place);
+static void unlink_timer(timing_wheel_t *wheel, int place);
+static int next_slot(timing_wheel_t *wheel, int level, int from);
+
+
+/*
+ * Function: wheel_init
+ * -------------------
+ * prepares an empty wheel at time 0
+ *
+ * wheel: the wheel
+ *
+ * returns: none
+ */
+void wheel_init(timing_wheel_t *wheel){
+	memset(wheel, 0, sizeof(timing_wheel_t));
+	memset(wheel->heads, -1, sizeof(wheel->heads));
+	wheel->due=INT_MAX;
+}
+
+/*
+ * Function: wheel_free
+ * -------------------
+ * frees the timers of the wheel
+ *
+ * wheel: the wheel
+ *
+ * returns: none
+ */
+void wheel_free(timing_wheel_t *wheel){
+	free(wheel->timers);
+	wheel_init(wheel);
+}
+
+/*
+ * Function: grow_places
+ * -------------------
+ * allocates the timers for as many places as the queue of the simulation has. The new
+ * places have no timer.
+ *
+ * sim: the simulation
+ * wheel: the wheel
+ *
+ * returns: none
+ */
+static void grow_places(simulation_t *sim, timing_wheel_t *wheel){
+	int look_up;
+	wheel->timers=realloc(wheel->timers, sizeof(wheel_timer_t)*sim->capacity);
+	if (wheel->timers==NULL){
+		out_of_memory(sim);
+	}
+	for (look_up=wheel->capacity; look_up<sim->capacity; look_up++){
+		wheel->timers[look_up].slot=-1;
+	}
+	wheel->capacity=sim->capacity;
+}
+
+/*
+ * Function: wheel_add
+ * -------------------
+ * adds the timer of the place, which expires at the given time. The place must not have
+ * a timer already. A timer whose time the wheel already got to is not added.
+ *
+ * sim: the simulation
+ * wheel: the wheel
+ * place: place of the process in the queue
+ * expiry: time at which the timer expires
+ *
+ * returns: 1 if the timer was added, 0 if it expired already
+ */
+int wheel_add(simulation_t *sim, timing_wheel_t *wheel, int place, int expiry){
+	if (expiry<=wheel->now){
+		return 0;
+	}
+	if (place>=wheel->capacity){
+		grow_places(sim, wheel);
+	}
+	wheel->timers[place].expiry=expiry;
+	link_timer(wheel, place);
+	wheel->count+=1;
+	return 1;
+}
+
+/*
+ * Function: wheel_cancel
+ * -------------------
+ * removes the timer of the place, if it has one
+ *
+ * wheel: the wheel
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+void wheel_cancel(timing_wheel_t *wheel, int place){
+	if (place<wheel->capacity && wheel->timers[place].slot!=-1){
+		unlink_timer(wheel, place);
+		wheel->count-=1;
+	}
+}
+
+/*
+ * Function: wheel_expire
+ * -------------------
+ * advances the wheel towards the time and takes out the next timer which expires by then,
+ * in order of their times. It is called until there is none, e.g.
+ * 		while ((place=wheel_expire(wheel, time))!=-1) ...
+ * and then the wheel is at the time. The time never goes back.
+ *
+ * wheel: the wheel
+ * time: time the wheel is advanced to
+ *
+ * returns: place of the expired timer, -1 if no other timer expires by the time
+ */
+int wheel_expire(timing_wheel_t *wheel, int time){
+	long long start; //time at which the slot starts
+	int level;
+	int slot;
+	int place;
+	int next;
+	while (wheel->count>0 && time>=wheel->due){
+		/*the first slot with timers is in the lowest level which has any ahead of the time of the wheel*/
+		for (level=0; level<WHEEL_LEVELS; level++){
+			slot=next_slot(wheel, level, (wheel->now>>(WHEEL_BITS*level))&(WHEEL_SLOTS-1));
+			if (slot!=-1){
+				break;
+			}
+		}
+		if (level==WHEEL_LEVELS){
+			wheel->due=INT_MAX;
+			break;
+		}
+		start=((long long)wheel->now>>(WHEEL_BITS*(level+1))<<(WHEEL_BITS*(level+1)))+((long long)slot<<(WHEEL_BITS*level));
+		if (start>time){
+			wheel->due=start<INT_MAX ? (int)start : INT_MAX;
+			break;
+		}
+		if (start>wheel->now){
+			wheel->now=(int)start;
+		}
+		if (level==0){
+			place=wheel->heads[0][slot];
+			unlink_timer(wheel, place);
+			wheel->count-=1;
+			return place;
+		}
+		/*the timers of the slot are spread over the lower levels*/
+		place=wheel->heads[level][slot];
+		wheel->heads[level][slot]=-1;
+		wheel->occupied[level][slot/WORD_BITS]&=~(1UL<<(slot%WORD_BITS));
+		while (place!=-1){
+			next=wheel->timers[place].next;
+			link_timer(wheel, place);
+			place=next;
+		}
+	}
+	if (wheel->count==0){
+		wheel->due=INT_MAX;
+	}
+	if (time>wheel->now){
+		wheel->now=time;
+	}
+	return -1;
+}
+
+/*
+ * Function: link_timer
+ * -------------------
+ * puts the timer of the place at the front of its slot: the slot of its time in the lowest
+ * level in which the time differs from the time of the wheel
+ *
+ * wheel: the wheel
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+static void link_timer(timing_wheel_t *wheel, int place){
+	wheel_timer_t *timer=&wheel->timers[place];
+	unsigned int differs=(unsigned int)(timer->expiry^wheel->now);
+	int level=0;
+	int slot;
+	int start; //time at which the slot starts
+	while (level<WHEEL_LEVELS-1 && (differs>>(WHEEL_BITS*(level+1)))!=0){
+		level+=1;
+	}
+	slot=(timer->expiry>>(WHEEL_BITS*level))&(WHEEL_SLOTS-1);
+	timer->previous=-1;
+	timer->next=wheel->heads[level][slot];
+	if (timer->next!=-1){
+		wheel->timers[timer->next].previous=place;
+	}
+	wheel->heads[level][slot]=place;
+	wheel->occupied[level][slot/WORD_BITS]|=1UL<<(slot%WORD_BITS);
+	timer->slot=level*WHEEL_SLOTS+slot;
+	start=timer->expiry&~((1<<(WHEEL_BITS*level))-1);
+	if (start<wheel->due){
+		wheel->due=start;
+	}
+}
+
+/*
+ * Function: unlink_timer
+ * -------------------
+ * takes the timer of the place out of its slot
+ *
+ * wheel: the wheel
+ * place: place of the process in the queue
+ *
+ * returns: none
+ */
+static void unlink_timer(timing_wheel_t *wheel, int place){
+	wheel_timer_t *timer=&wheel->timers[place];
+	int level=timer->slot/WHEEL_SLOTS;
+	int slot=timer->slot%WHEEL_SLOTS;
+	if (timer->previous!=-1){
+		wheel->timers[timer->previous].next=timer->next;
+	}
+	else{
+		wheel->heads[level][slot]=timer->next;
+		if (timer->next==-1){
+			wheel->occupied[level][slot/WORD_BITS]&=~(1UL<<(slot%WORD_BITS));
+		}
+	}
+	if (timer->next!=-1){
+		wheel->timers[timer->next].previous=timer->previous;
+	}
+	timer->slot=-1;
+}
+
+/*
+ * Function: next_slot
+ * -------------------
+ * Finds the first slot of the level with timers, from the given one on
+ *
+ * wheel: the wheel
+ * level: the level
+ * from: first slot looked at
+ *
+ * returns: the slot, -1 if there is none
+ */
+static int next_slot(timing_wheel_t *wheel, int level, int from){
+	int word=from/WORD_BITS;
+	unsigned long bits=wheel->occupied[level][word]&(~0UL<<(from%WORD_BITS));
+	while (1){
+		if (bits!=0){
+#if defined(__GNUC__)
+			return word*WORD_BITS+__builtin_ctzl(bits);
+#else
+			from=word*WORD_BITS;
+			while (((bits>>(from%WORD_BITS))&1UL)==0){
+				from+=1;
+			}
+			return from;
+#endif
+		}
+		word+=1;
+		if (word==WHEEL_SLOTS/WORD_BITS){
+			return -1;
+		}
+		bits=wheel->occupied[level][word];
+	}
+}
@@ -0,0 +1,398 @@
+/*
+ * Name: Sutulova Tatiana
+ * -------------------------
+ *
+ * Traces: the processes of a file read in advance (trace_t), so that they can be
+ * simulated several times. The processes are kept in columns, one per field, with
+ * the names in a table of their own. They are either parsed from a text file or
+ * mapped straight from a binary trace file, which holds the same columns:
+ *
+ *		header (trace_header_t, 24 bytes)
+ *		entry times (count ints)
+ *		service times (count ints)
+ *		deadlines (count ints)
+ *		tickets (count ints)
+ *		offsets of the names (count+1 unsigned ints)
+ *		names (the characters of all the names, one after another)
+ *
+ * in the byte order of the machine that wrote it. A binary trace is therefore not
+ * parsed at all: loading it only maps the file into memory, and its pages are read
+ * as the processes enter the system. The binary trace is written by write_trace(), or
+ * process by process by a trace writer (see open_trace_writer()).
+ * A trace of the first version, which has no tickets, is still mapped, and its processes
+ * have DEFAULT_TICKETS each.
+ */
+
+#include <stdio.h>      /* standard I/O routines */
+#include <stdlib.h>     /* needed for exit function */
+#include <string.h>     /* memcmp, memcpy */
+#include <fcntl.h>      /* open */
+#include <unistd.h>     /* close */
+#include <sys/mman.h>   /* mmap */
+#include <sys/stat.h>   /* fstat */
+#include "scheduler.h"
+#define TRACE_MAGIC "SCHTRACE" //first bytes of a binary trace file
+#define TRACE_VERSION 2 //version of the binary trace format
+#define TRACE_VERSION_NO_TICKETS 1 //version of the binary trace format before the tickets
+
+/* Header of a binary trace file*/
+typedef struct{
+	char magic[8]; //TRACE_MAGIC
+	unsigned int version; //TRACE_VERSION, in the byte order of the machine that wrote it
+	unsigned int count; //number of processes
+	unsigned int names_size; //number of characters in the table of the names
+	unsigned int reserved; //0, keeps the columns aligned
+} trace_header_t;
+
+/*functions*/
+static void *grow_column(void *column, int capacity, size_t size);
+
+
+/*
+ * Function: read_trace
+ * -------------------
+ * reads all the processes of the text file into the trace in advance, so that they can
+ * be simulated several times (and by several simulations at the same time)
+ *
+ * fp: file to be read from
+ * trace: trace to be read into
+ *
+ * returns: none
+ */
+void read_trace(FILE *fp, trace_t *trace){
+	reader_t *reader=open_reader(fp);
+	pcb_t process;
+
+	memset(trace, 0, sizeof(trace_t));
+	while (read_process(reader, &process)){
+		append_trace(trace, &process);
+	}
+	free(reader);
+	/*an empty file still has the offset of the first name*/
+	if (trace->name_offsets==NULL){
+		trace->name_offsets=grow_column(NULL, 1, sizeof(unsigned int));
+		trace->name_offsets[0]=0;
+	}
+}
+
+/*
+ * Function: append_trace
+ * -------------------
+ * adds the process at the end of the trace, growing its columns if they are full. The
+ * trace is to be read from a text file (or empty), not mapped.
+ *
+ * trace: the trace
+ * process: the process
+ *
+ * returns: none
+ */
+void append_trace(trace_t *trace, pcb_t *process){
+	int length=strlen(process->processname);
+	if (trace->count==trace->capacity){
+		trace->capacity=trace->capacity==0 ? INITIAL_CAPACITY : trace->capacity*2;
+		trace->entryTime=grow_column(trace->entryTime, trace->capacity, sizeof(int));
+		trace->serviceTime=grow_column(trace->serviceTime, trace->capacity, sizeof(int));
+		trace->deadline=grow_column(trace->deadline, trace->capacity, sizeof(int));
+		trace->tickets=grow_column(trace->tickets, trace->capacity, sizeof(int));
+		trace->name_offsets=grow_column(trace->name_offsets, trace->capacity+1, sizeof(unsigned int));
+		if (trace->count==0){
+			trace->name_offsets[0]=0; //the first name starts at the beginning of the table
+		}
+	}
+	if (trace->name_offsets[trace->count]+length>trace->names_capacity){
+		trace->names_capacity=trace->names_capacity==0 ? INITIAL_CAPACITY*NAME_SIZE : trace->names_capacity*2;
+		trace->names=grow_column(trace->names, trace->names_capacity, 1);
+	}
+	trace->entryTime[trace->count]=process->entryTime;
+	trace->serviceTime[trace->count]=process->serviceTime;
+	trace->deadline[trace->count]=process->deadline;
+	trace->tickets[trace->count]=process->tickets;
+	memcpy(trace->names+trace->name_offsets[trace->count], process->processname, length);
+	trace->name_offsets[trace->count+1]=trace->name_offsets[trace->count]+length;
+	trace->count+=1;
+	trace->names_size=trace->name_offsets[trace->count];
+}
+
+/*
+ * Function: grow_column
+ * -------------------
+ * changes the number of elements allocated for a column of the trace
+ *
+ * column: the column
+ * capacity: number of elements
+ * size: size of an element
+ *
+ * returns: the column, which may have moved
+ */
+static void *grow_column(void *column, int capacity, size_t size){
+	column=realloc(column, size*capacity);
+	if (column==NULL){
+		printf("There is not enough memory for the processes");
+		exit(0);
+	}
+	return column;
+}
+
+/*
+ * Function: map_trace
+ * -------------------
+ * maps the binary trace file into memory, if the file is one. The columns of the
+ * trace point straight into the file. Only a regular file is looked at: the first bytes
+ * of a pipe (or of anything else which cannot be mapped) would be lost to the text
+ * reader, so it is never opened here.
+ *
+ * filename: name of the file
+ * trace: trace to be mapped into
+ *
+ * returns: 1 if the file is a binary trace, 0 otherwise (or if it cannot be open)
+ */
+int map_trace(char *filename, trace_t *trace){
+	trace_header_t header;
+	struct stat file;
+	size_t size;
+	char *mapping;
+	int columns; //number of int columns
+	int fd;
+
+	if (stat(filename, &file)!=0 || !S_ISREG(file.st_mode)){
+		return 0;
+	}
+	fd=open(filename, O_RDONLY);
+	if (fd==-1){
+		return 0;
+	}
+	if (read(fd, &header, sizeof(trace_header_t))!=sizeof(trace_header_t) || memcmp(header.magic, TRACE_MAGIC, 8)){
+		close(fd);
+		return 0;
+	}
+	if (header.version!=TRACE_VERSION && header.version!=TRACE_VERSION_NO_TICKETS){
+		printf("The trace file was written by another version or on a machine with another byte order");
+		exit(0);
+	}
+	columns=header.version==TRACE_VERSION ? 4 : 3;
+	size=sizeof(trace_header_t)+(size_t)header.count*columns*sizeof(int)+((size_t)header.count+1)*sizeof(unsigned int)+header.names_size;
+	if (fstat(fd, &file)!=0 || (size_t)file.st_size!=size){
+		printf("The trace file is damaged");
+		exit(0);
+	}
+	mapping=mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping==MAP_FAILED){
+		printf("The trace file could not be open. Try again");
+		exit(0);
+	}
+	/*the processes are read in order*/
+	madvise(mapping, size, MADV_SEQUENTIAL);
+
+	trace->count=header.count;
+	trace->entryTime=(int *)(mapping+sizeof(trace_header_t));
+	trace->serviceTime=trace->entryTime+header.count;
+	trace->deadline=trace->serviceTime+header.count;
+	trace->tickets=NULL;
+	if (header.version==TRACE_VERSION){
+		trace->tickets=trace->deadline+header.count;
+	}
+	trace->name_offsets=(unsigned int *)(trace->deadline+(columns-2)*header.count);
+	trace->names=(char *)(trace->name_offsets+header.count+1);
+	trace->names_size=header.names_size;
+	trace->mapping=mapping;
+	trace->mapping_size=size;
+	return 1;
+}
+
+/*
+ * Function: write_trace
+ * -------------------
+ * writes the trace into a binary trace file, which can be mapped by map_trace()
+ *
+ * trace: the trace
+ * filename: name of the file
+ *
+ * returns: none
+ */
+void write_trace(trace_t *trace, char *filename){
+	trace_header_t header;
+	int tickets=DEFAULT_TICKETS;
+	int index;
+	FILE *fp=fopen(filename, "wb");
+	if (fp==NULL){
+		printf("The trace file could not be open. Try again");
+		exit(0);
+	}
+	memset(&header, 0, sizeof(trace_header_t));
+	memcpy(header.magic, TRACE_MAGIC, 8);
+	header.version=TRACE_VERSION;
+	header.count=trace->count;
+	header.names_size=trace->names_size;
+	fwrite(&header, sizeof(trace_header_t), 1, fp);
+	fwrite(trace->entryTime, sizeof(int), trace->count, fp);
+	fwrite(trace->serviceTime, sizeof(int), trace->count, fp);
+	fwrite(trace->deadline, sizeof(int), trace->count, fp);
+	if (trace->tickets!=NULL){
+		fwrite(trace->tickets, sizeof(int), trace->count, fp);
+	}
+	else{
+		/*a trace of the first version gets the tickets its processes have*/
+		for (index=0; index<trace->count; index++){
+			fwrite(&tickets, sizeof(int), 1, fp);
+		}
+	}
+	fwrite(trace->name_offsets, sizeof(unsigned int), trace->count+1, fp);
+	fwrite(trace->names, 1, header.names_size, fp);
+	if (fclose(fp)!=0){
+		printf("The trace file could not be written");
+		exit(0);
+	}
+}
+
+/*
+ * Function: open_trace_writer
+ * -------------------
+ * creates the binary trace file for the given number of processes and characters of
+ * their names, and opens a stream for each of its columns, starting where the column
+ * starts, so that the processes can be written one by one without keeping them all in
+ * memory (see write_trace_process())
+ *
+ * writer: writer to be opened
+ * filename: name of the file
+ * count: number of processes to be written
+ * names_size: number of characters of all their names
+ * buffer_size: size of the buffer of every stream, all of them allocated here
+ *
+ * returns: none
+ */
+void open_trace_writer(trace_writer_t *writer, char *filename, int count, unsigned int names_size, long buffer_size){
+	trace_header_t header;
+	unsigned int offset=0;
+	long starts[6]; //where the columns start in the file
+	int look_up;
+
+	writer->buffers=malloc(6*buffer_size);
+	if (writer->buffers==NULL){
+		printf("There is not enough memory to write the trace file");
+		exit(0);
+	}
+	starts[0]=0;
+	for (look_up=1; look_up<5; look_up++){
+		starts[look_up]=sizeof(trace_header_t)+(long)look_up*count*sizeof(int);
+	}
+	starts[5]=starts[4]+((long)count+1)*sizeof(unsigned int);
+	for (look_up=0; look_up<6; look_up++){
+		/*the first stream creates the file, the others write into it*/
+		writer->columns[look_up]=fopen(filename, look_up==0 ? "wb" : "r+b");
+		if (writer->columns[look_up]==NULL || setvbuf(writer->columns[look_up], writer->buffers+look_up*buffer_size, _IOFBF, buffer_size)!=0 || fseek(writer->columns[look_up], starts[look_up], SEEK_SET)!=0){
+			printf("The trace file could not be open. Try again");
+			exit(0);
+		}
+	}
+	memset(&header, 0, sizeof(trace_header_t));
+	memcpy(header.magic, TRACE_MAGIC, 8);
+	header.version=TRACE_VERSION;
+	header.count=count;
+	header.names_size=names_size;
+	fwrite(&header, sizeof(trace_header_t), 1, writer->columns[0]);
+	fwrite(&offset, sizeof(unsigned int), 1, writer->columns[4]);
+	writer->name_offset=0;
+}
+
+/*
+ * Function: write_trace_process
+ * -------------------
+ * writes the next process into the columns of the binary trace file
+ *
+ * writer: the writer
+ * process: the process
+ *
+ * returns: none
+ */
+void write_trace_process(trace_writer_t *writer, pcb_t *process){
+	int length=strlen(process->processname);
+	fwrite(&process->entryTime, sizeof(int), 1, writer->columns[0]);
+	fwrite(&process->serviceTime, sizeof(int), 1, writer->columns[1]);
+	fwrite(&process->deadline, sizeof(int), 1, writer->columns[2]);
+	fwrite(&process->tickets, sizeof(int), 1, writer->columns[3]);
+	writer->name_offset+=length;
+	fwrite(&writer->name_offset, sizeof(unsigned int), 1, writer->columns[4]);
+	fwrite(process->processname, 1, length, writer->columns[5]);
+}
+
+/*
+ * Function: close_trace_writer
+ * -------------------
+ * writes out what is left in the buffers of the columns, closes the binary trace file and
+ * frees the buffers
+ *
+ * writer: the writer
+ *
+ * returns: none
+ */
+void close_trace_writer(trace_writer_t *writer){
+	int failed=0;
+	int look_up;
+	for (look_up=0; look_up<6; look_up++){
+		if (fclose(writer->columns[look_up])!=0){
+			failed=1;
+		}
+	}
+	free(writer->buffers);
+	if (failed){
+		printf("The trace file could not be written");
+		exit(0);
+	}
+}
+
+/*
+ * Function: free_trace
+ * -------------------
+ * frees the columns of the trace, or unmaps the file they are in
+ *
+ * trace: the trace
+ *
+ * returns: none
+ */
+void free_trace(trace_t *trace){
+	if (trace->mapping!=NULL){
+		munmap(trace->mapping, trace->mapping_size);
+	}
+	else{
+		free(trace->entryTime);
+		free(trace->serviceTime);
+		free(trace->deadline);
+		free(trace->tickets);
+		free(trace->name_offsets);
+		free(trace->names);
+	}
+	memset(trace, 0, sizeof(trace_t));
+}
+
+/*
+ * Function: trace_process
+ * -------------------
+ * copies the process of the trace out of the columns. A name longer than 10
+ * characters (in a damaged file) is cut, as it is when read from the text file.
+ *
+ * trace: the trace
+ * index: index of the process in the trace
+ * process: process to be copied into
+ *
+ * returns: none
+ */
+void trace_process(trace_t *trace, int index, pcb_t *process){
+	unsigned int start=trace->name_offsets[index];
+	unsigned int end=trace->name_offsets[index+1];
+	if (end>trace->names_size || start>end){
+		start=end=0;
+	}
+	if (end-start>NAME_SIZE-1){
+		end=start+NAME_SIZE-1;
+	}
+	process->entryTime=trace->entryTime[index];
+	process->serviceTime=trace->serviceTime[index];
+	process->deadline=trace->deadline[index];
+	process->tickets=DEFAULT_TICKETS;
+	if (trace->tickets!=NULL && trace->tickets[index]>0){
+		process->tickets=trace->tickets[index];
+	}
+	memcpy(process->processname, trace->names+start, end-start);
+	process->processname[end-start]='\0';
+}